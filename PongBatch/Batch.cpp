@@ -0,0 +1,301 @@
+#include <iostream>
+#include <random>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+#include "Simulation.h"
+#include "Collision.h"
+#include "BallField.h"
+#include "CollisionKernels.h"
+#include "VectorEnv.h"
+#include "AiController.h"
+#include "MatchFarm.h"
+
+//Headless benchmarks and checks for the simulation library. These used to be flags on the game,
+//which meant a window, SFML and Windows just to measure something that never draws.
+
+static float SecondsSince(std::chrono::steady_clock::time_point start) {
+	return std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+}
+
+//Steps a BallField without a window and reports ball updates per second
+void RunBallBenchmark(size_t ballCount, float tickRate, uint64_t seed, float seconds) {
+	BallField field(MatchConfig(), 3.0f, seed);
+	field.Spawn(ballCount);
+
+	MatchConfig config;
+	float paddleY = ToFloat(config.courtHeight - config.paddleHeight) / 2;
+	float deltaTime = 1.0f / tickRate;
+
+	auto start = std::chrono::steady_clock::now();
+	size_t ticks = 0;
+	size_t paddleHits = 0;
+	while (SecondsSince(start) < seconds) {
+		paddleHits += field.Step(paddleY, paddleY, deltaTime).paddleHits;
+		ticks++;
+	}
+
+	float elapsed = SecondsSince(start);
+	std::cout << ContactKernelName() << " kernels, " << ballCount << " balls, " << ticks << " ticks in " << elapsed << "s: "
+		<< (ticks / elapsed) << " ticks/s, " << (ballCount * ticks / elapsed / 1000000.0f) << "M ball updates/s, "
+		<< paddleHits << " paddle hits" << std::endl;
+}
+
+//Steps a VectorEnv with a simple ball-following policy and reports agent steps per second
+void RunEnvBenchmark(size_t matchCount, int threadCount, uint64_t seed, float seconds) {
+	VectorEnvConfig config;
+	config.seed = seed;
+	VectorEnv env(matchCount, config, threadCount);
+	std::vector<int8_t> actions(matchCount);
+
+	auto start = std::chrono::steady_clock::now();
+	size_t calls = 0;
+	size_t finishedMatches = 0;
+	while (SecondsSince(start) < seconds) {
+		const float* observations = env.Observations();
+		for (size_t i = 0; i < matchCount; i++) {
+			const float* observation = &observations[i * VectorEnv::ObservationSize];
+			actions[i] = observation[1] < observation[4] ? (int8_t)PaddleInput::Up : (int8_t)PaddleInput::Down;
+		}
+
+		env.Step(actions.data());
+		calls++;
+
+		const uint8_t* dones = env.Dones();
+		for (size_t i = 0; i < matchCount; i++) {
+			finishedMatches += dones[i];
+		}
+	}
+
+	float elapsed = SecondsSince(start);
+	std::cout << matchCount << " matches on " << threadCount << " threads: " << (calls * matchCount / elapsed / 1000000.0f)
+		<< "M agent steps/s, " << finishedMatches << " matches finished" << std::endl;
+}
+
+//Round robin between a ladder of AI difficulties, reporting wins per controller and matches per second
+void RunTournament(int gamesPerPair, int threadCount, uint64_t seed) {
+	std::vector<AiSettings> controllers;
+	const float delays[] = { 0.1f, 0.25f, 0.5f, 1.0f };
+	const float noises[] = { 0.0f, 60.0f, 120.0f };
+	for (float delay : delays) {
+		for (float noise : noises) {
+			AiSettings settings;
+			settings.reactionDelay = delay;
+			settings.errorNoise = noise;
+			controllers.push_back(settings);
+		}
+	}
+
+	FarmConfig config;
+	config.threadCount = threadCount;
+
+	MatchFarm farm(config, controllers);
+	std::vector<MatchJob> jobs = farm.RoundRobin(gamesPerPair, seed);
+	FarmReport report = farm.Run(jobs);
+
+	for (size_t i = 0; i < controllers.size(); i++) {
+		std::cout << "delay " << controllers[i].reactionDelay << "s noise " << controllers[i].errorNoise << "px: " << report.wins[i] << " wins" << std::endl;
+	}
+	std::cout << jobs.size() << " matches on " << threadCount << " threads in " << report.seconds << "s: "
+		<< report.matchesPerSecond << " matches/s" << std::endl;
+}
+
+//Plays the same random inputs through Step and FastForward and compares how often each produces
+//walls, paddle hits and goals. The two drift apart within a rally, so only the rates should agree.
+void RunFastForwardCheck(float tickRate, uint64_t seed) {
+	const int seeds = 16;
+	const int segments = 10000;
+	const float segmentLength = 0.5f;
+	int ticksPerSegment = (int)(segmentLength * tickRate + 0.5f);
+	Real deltaTime = Real(segmentLength / ticksPerSegment);
+
+	MatchTally stepped;
+	MatchTally jumped;
+	for (int i = 0; i < seeds; i++) {
+		Match stepMatch(MatchConfig(), seed + i);
+		Match jumpMatch(MatchConfig(), seed + i);
+		Rng inputs(seed + i, 1);
+
+		for (int j = 0; j < segments; j++) {
+			PaddleInput left = (PaddleInput)((int)inputs.NextBelow(3) - 1);
+			PaddleInput right = (PaddleInput)((int)inputs.NextBelow(3) - 1);
+
+			for (int tick = 0; tick < ticksPerSegment; tick++) {
+				uint32_t events = stepMatch.Step(left, right, deltaTime);
+				if (events & EventWallHit) stepped.wallHits++;
+				if (events & EventLeftPaddleHit) stepped.leftPaddleHits++;
+				if (events & EventRightPaddleHit) stepped.rightPaddleHits++;
+				if (events & EventLeftGoal) stepped.leftGoals++;
+				if (events & EventRightGoal) stepped.rightGoals++;
+			}
+			jumpMatch.FastForward(left, right, Real(segmentLength), &jumped);
+		}
+	}
+
+	auto report = [](const char* name, int step, int fast) {
+		float difference = step > 0 ? 100.0f * (fast - step) / step : 0.0f;
+		std::cout << name << ": Step " << step << ", FastForward " << fast << " (" << difference << "%)" << std::endl;
+	};
+	std::cout << seeds * segments * segmentLength << "s of play per simulator at " << tickRate << "Hz" << std::endl;
+	report("wall hits", stepped.wallHits, jumped.wallHits);
+	report("paddle hits", stepped.leftPaddleHits + stepped.rightPaddleHits, jumped.leftPaddleHits + jumped.rightPaddleHits);
+	report("goals", stepped.leftGoals + stepped.rightGoals, jumped.leftGoals + jumped.rightGoals);
+}
+
+//Distance from (x, y) to the nearest point of box, in doubles
+static double BoxDistance(double x, double y, const Aabb& box) {
+	double dx = x - std::min(std::max(x, (double)ToFloat(box.left)), (double)ToFloat(box.right));
+	double dy = y - std::min(std::max(y, (double)ToFloat(box.top)), (double)ToFloat(box.bottom));
+	return std::sqrt(dx * dx + dy * dy);
+}
+
+//FastForward sweeps the ball across a whole rally at once, so SweepCircleAabb sees movements
+//hundreds of pixels long. This aims long sweeps past a paddle's corners and compares each result
+//with a double precision march along the same path, which catches fixed point overflow as well
+//as precision loss. Grazing paths within a hair of the radius are skipped as too close to call.
+void RunSweepCheck(uint64_t seed) {
+	MatchConfig config;
+	Real radius = config.ballRadius;
+	Aabb box = { config.leftPaddleX, Real(300), config.leftPaddleX + config.paddleWidth, Real(400) };
+	double r = ToFloat(radius);
+
+	Rng rng(seed, 2);
+	const int sweeps = 200000;
+	int checked = 0;
+	int missed = 0;
+	int extra = 0;
+	int misplaced = 0;
+	for (int i = 0; i < sweeps; i++) {
+		double cornerX = ToFloat(rng.NextBool() ? box.left : box.right);
+		double cornerY = ToFloat(rng.NextBool() ? box.top : box.bottom);
+
+		//Start near a corner but clear of the paddle, aim at the corner and carry on a long way
+		double startX = cornerX + (rng.NextFloat() * 2.0f - 1.0f) * 80.0f;
+		double startY = cornerY + (rng.NextFloat() * 2.0f - 1.0f) * 80.0f;
+		double aimX = cornerX + (rng.NextFloat() * 2.0f - 1.0f) * 30.0f - startX;
+		double aimY = cornerY + (rng.NextFloat() * 2.0f - 1.0f) * 30.0f - startY;
+		double aimLength = std::sqrt(aimX * aimX + aimY * aimY);
+		double length = 50.0 + rng.NextFloat() * 950.0;
+		if (aimLength <= 0.0) continue;
+
+		Vec2 centre = { Real((float)startX), Real((float)startY) };
+		Vec2 delta = { Real((float)(aimX / aimLength * length)), Real((float)(aimY / aimLength * length)) };
+
+		//The reference works from the inputs as the simulation sees them
+		double x = ToFloat(centre.x);
+		double y = ToFloat(centre.y);
+		double dx = ToFloat(delta.x);
+		double dy = ToFloat(delta.y);
+		length = std::sqrt(dx * dx + dy * dy);
+		if (BoxDistance(x, y, box) <= r + 0.5) continue;
+
+		//March in quarter pixels to the first step within the radius, then bisect
+		int steps = (int)(length * 4.0) + 1;
+		double closest = BoxDistance(x, y, box);
+		double expected = -1.0;
+		for (int step = 1; step <= steps; step++) {
+			double t = (double)step / steps;
+			double distance = BoxDistance(x + dx * t, y + dy * t, box);
+			closest = std::min(closest, distance);
+			if (distance <= r) {
+				double low = (double)(step - 1) / steps;
+				double high = t;
+				for (int j = 0; j < 40; j++) {
+					double middle = (low + high) / 2;
+					if (BoxDistance(x + dx * middle, y + dy * middle, box) <= r) high = middle;
+					else low = middle;
+				}
+				expected = high;
+				break;
+			}
+		}
+		if (std::fabs(closest - r) < 0.05) continue;
+
+		SweepHit hit;
+		bool found = SweepCircleAabb(centre, delta, radius, box, hit);
+		checked++;
+
+		if (expected < 0.0 && found) extra++;
+		else if (expected >= 0.0 && !found) missed++;
+		else if (found && std::fabs(ToFloat(hit.time) - expected) * length > 0.1) misplaced++;
+	}
+
+	std::cout << checked << " long sweeps past a paddle corner: " << missed << " hits missed, " << extra
+		<< " false hits, " << misplaced << " hits more than 0.1px from the reference" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+	float tickRate = 120.0f;
+	size_t ballCount = 0;
+	bool benchmark = false;
+	bool fastForwardCheck = false;
+	bool sweepCheck = false;
+	size_t envMatches = 0;
+	int threadCount = (int)std::thread::hardware_concurrency();
+	uint64_t seed = std::random_device()();
+	int tournamentGames = 0;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--tick-rate") == 0 && i + 1 < argc) {
+			tickRate = (float)atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--balls") == 0 && i + 1 < argc) {
+			ballCount = (size_t)atol(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--benchmark") == 0) {
+			benchmark = true;
+		}
+		else if (strcmp(argv[i], "--fast-forward-check") == 0) {
+			fastForwardCheck = true;
+		}
+		else if (strcmp(argv[i], "--sweep-check") == 0) {
+			sweepCheck = true;
+		}
+		else if (strcmp(argv[i], "--env-benchmark") == 0 && i + 1 < argc) {
+			envMatches = (size_t)atol(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+			threadCount = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+			seed = strtoull(argv[++i], nullptr, 10);
+		}
+		else if (strcmp(argv[i], "--tournament") == 0 && i + 1 < argc) {
+			tournamentGames = atoi(argv[++i]);
+		}
+	}
+
+	if (tickRate <= 0.0f) {
+		std::cout << "[ERROR: Batch.cpp]: Tick rate must be positive, using 120" << std::endl;
+		tickRate = 120.0f;
+	}
+
+	if (benchmark) {
+		RunBallBenchmark(ballCount > 0 ? ballCount : 100000, tickRate, seed, 5.0f);
+	}
+	else if (fastForwardCheck) {
+		RunFastForwardCheck(tickRate, seed);
+	}
+	else if (sweepCheck) {
+		RunSweepCheck(seed);
+	}
+	else if (tournamentGames > 0) {
+		RunTournament(tournamentGames, threadCount > 0 ? threadCount : 1, seed);
+	}
+	else if (envMatches > 0) {
+		RunEnvBenchmark(envMatches, threadCount > 0 ? threadCount : 1, seed, 5.0f);
+	}
+	else {
+		std::cout << "Usage: PongBatch [--seed n] [--tick-rate hz] [--threads n] --benchmark [--balls n] | --env-benchmark matches" << std::endl
+			<< "       | --tournament gamesPerPair | --fast-forward-check | --sweep-check" << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,82 @@
+#include "AiController.h"
+
+AiController::AiController(PaddleSide side, const AiSettings& settings, uint64_t seed) : side(side), settings(settings), rng(seed) {
+	Reset();
+}
+
+void AiController::Reset() {
+	target = SCREEN_HEIGHT / 2;
+	sinceLastPlan = 0;
+	planned = false;
+}
+
+void AiController::Seed(uint64_t seed, uint64_t stream) {
+	rng.Seed(seed, stream);
+}
+
+bool AiController::PredictCrossing(const BallState& ball, const MatchConfig& config, Real planeX, Real& crossingY) {
+	Real radius = config.ballRadius;
+	Real centreX = ball.position.x + radius;
+	Real centreY = ball.position.y + radius;
+
+	Real towardPlane = planeX - centreX;
+	if (ball.velocity.x == Real(0) || (towardPlane > Real(0)) != (ball.velocity.x > Real(0))) return false;
+
+	//Straight line to the plane as if there were no walls
+	Real time = towardPlane / ball.velocity.x;
+	Real unfolded = centreY + ball.velocity.y * time - radius;
+
+	//The centre bounces between radius and courtHeight - radius. Reflections make that a
+	//triangle wave with period twice the span, so fold the unfolded height back into it.
+	Real span = config.courtHeight - radius * 2;
+	Real period = span * 2;
+
+	int wraps = ToInt(unfolded / period);
+	Real phase = unfolded - period * Real(wraps);
+	if (phase < Real(0)) phase += period;
+	if (phase >= period) phase -= period;
+
+	Real folded = phase < span ? phase : period - phase;
+	crossingY = folded + radius;
+	return true;
+}
+
+void AiController::Plan(const MatchState& state, const MatchConfig& config) {
+	//Where the ball's centre is when it touches the paddle's face
+	Real planeX = side == PaddleSide::Left ?
+		config.leftPaddleX + config.paddleWidth + config.ballRadius :
+		config.rightPaddleX - config.ballRadius;
+
+	Real crossingY;
+	if (!PredictCrossing(state.ball, config, planeX, crossingY)) {
+		//Ball is heading away: drift back to the middle
+		target = config.courtHeight / 2;
+		return;
+	}
+
+	int noise = (int)settings.errorNoise;
+	if (noise > 0) {
+		crossingY += Real((int)rng.NextBelow(noise * 2 + 1) - noise);
+	}
+
+	target = crossingY;
+}
+
+PaddleInput AiController::Decide(const MatchState& state, const MatchConfig& config, Real deltaTime) {
+	sinceLastPlan += deltaTime;
+	if (!planned || sinceLastPlan >= Real(settings.reactionDelay)) {
+		Plan(state, config);
+		sinceLastPlan = 0;
+		planned = true;
+	}
+
+	const PaddleState& paddle = side == PaddleSide::Left ? state.left : state.right;
+	Real paddleCentre = paddle.y + config.paddleHeight / 2;
+
+	//Stop once within a step of the target so the paddle doesn't oscillate around it
+	Real tolerance = config.paddleSpeed * deltaTime;
+
+	if (target < paddleCentre - tolerance) return PaddleInput::Up;
+	if (target > paddleCentre + tolerance) return PaddleInput::Down;
+	return PaddleInput::Idle;
+}
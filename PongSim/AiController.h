@@ -0,0 +1,47 @@
+#pragma once
+#include "Simulation.h"
+#include "Random.h"
+
+enum class PaddleSide {
+	Left,
+	Right
+};
+
+struct AiSettings {
+	//Seconds between looks at the ball; the paddle keeps chasing its last target in between
+	float reactionDelay = 0.1f;
+
+	//Largest aiming error in pixels, drawn uniformly each time the paddle re-plans
+	float errorNoise = 20.0f;
+};
+
+//Computer opponent. Predicts where the ball will cross the paddle's face in closed form, folding
+//wall bounces back into the court instead of stepping the simulation, so each decision is O(1).
+class AiController {
+public:
+	AiController(PaddleSide side = PaddleSide::Right, const AiSettings& settings = AiSettings(), uint64_t seed = 0);
+
+	void Reset();
+
+	//Restarts the aiming noise from a known point, so a replay makes the same decisions
+	void Seed(uint64_t seed, uint64_t stream);
+
+	PaddleInput Decide(const MatchState& state, const MatchConfig& config, Real deltaTime);
+
+	//Ball centre y when its centre reaches planeX, or false if it is moving away from the plane.
+	//Ignores paddles, so it is exact up to the next paddle contact.
+	static bool PredictCrossing(const BallState& ball, const MatchConfig& config, Real planeX, Real& crossingY);
+
+	const AiSettings& GetSettings() const { return settings; }
+
+private:
+	void Plan(const MatchState& state, const MatchConfig& config);
+
+	PaddleSide side;
+	AiSettings settings;
+	Rng rng;
+
+	Real target;
+	Real sinceLastPlan;
+	bool planned = false;
+};
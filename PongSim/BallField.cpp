@@ -0,0 +1,115 @@
+#include "BallField.h"
+#include "CollisionKernels.h"
+#include <cmath>
+
+BallField::BallField(const MatchConfig& config, float radius, uint64_t seed) : radius(radius), rng(seed) {
+	courtWidth = ToFloat(config.courtWidth);
+	courtHeight = ToFloat(config.courtHeight);
+	paddleWidth = ToFloat(config.paddleWidth);
+	paddleHeight = ToFloat(config.paddleHeight);
+	leftPaddleX = ToFloat(config.leftPaddleX);
+	rightPaddleX = ToFloat(config.rightPaddleX);
+	ballSpeed = ToFloat(config.ballSpeed);
+}
+
+void BallField::Spawn(size_t count) {
+	size_t first = x.size();
+
+	x.resize(first + count);
+	y.resize(first + count);
+	vx.resize(first + count);
+	vy.resize(first + count);
+
+	for (size_t i = first; i < x.size(); i++) {
+		Respawn(i);
+
+		//Spread the new balls over the court so they don't all move as one clump
+		x[i] = rng.NextFloat() * (courtWidth - radius * 2.0f);
+		y[i] = rng.NextFloat() * (courtHeight - radius * 2.0f);
+	}
+}
+
+void BallField::Clear() {
+	x.clear();
+	y.clear();
+	vx.clear();
+	vy.clear();
+}
+
+void BallField::Respawn(size_t index) {
+	x[index] = courtWidth / 2;
+	y[index] = courtHeight / 2;
+
+	vx[index] = rng.NextBool() ? ballSpeed : -ballSpeed;
+	vy[index] = (rng.NextFloat() * 2.0f - 1.0f) * ballSpeed;
+}
+
+BallField::Stats BallField::Step(float leftPaddleY, float rightPaddleY, float deltaTime) {
+	Stats stats;
+
+	size_t count = x.size();
+	float size = radius * 2.0f;
+
+	float* px = x.data();
+	float* py = y.data();
+	float* pvx = vx.data();
+	float* pvy = vy.data();
+
+	for (size_t i = 0; i < count; i++) {
+		px[i] += pvx[i] * deltaTime;
+		py[i] += pvy[i] * deltaTime;
+	}
+
+	//Walls first, mirroring any overshoot back into the court, so the paddles are tested against
+	//where each ball really ends up
+	float maxY = courtHeight - size;
+	contacts.resize(count);
+	uint8_t* pc = contacts.data();
+	TestContacts(px, py, count, size, 0.0f, maxY, nullptr, 0, pc);
+
+	size_t wallHits = 0;
+	for (size_t i = 0; i < count; i++) {
+		uint8_t bits = pc[i];
+
+		float top = py[i];
+		float speed = std::fabs(pvy[i]);
+		bool hitTop = (bits & ContactTopWall) != 0;
+		bool hitBottom = (bits & ContactBottomWall) != 0;
+
+		py[i] = hitTop ? -top : (hitBottom ? 2.0f * maxY - top : top);
+		pvy[i] = hitTop ? speed : (hitBottom ? -speed : pvy[i]);
+		wallHits += hitTop | hitBottom;
+	}
+
+	//Paddles only bounce balls heading into them. The wall bits of this pass are ignored.
+	KernelBox paddles[2] = {
+		{ leftPaddleX, leftPaddleY, leftPaddleX + paddleWidth, leftPaddleY + paddleHeight },
+		{ rightPaddleX, rightPaddleY, rightPaddleX + paddleWidth, rightPaddleY + paddleHeight }
+	};
+	TestContacts(px, py, count, size, 0.0f, maxY, paddles, 2, pc);
+
+	float leftFace = leftPaddleX + paddleWidth;
+	float rightFace = rightPaddleX - size;
+	size_t paddleHits = 0;
+	for (size_t i = 0; i < count; i++) {
+		uint8_t bits = pc[i];
+
+		bool hitLeft = (bits & ContactFirstBox) != 0 && pvx[i] < 0.0f;
+		bool hitRight = (bits & (ContactFirstBox << 1)) != 0 && pvx[i] > 0.0f;
+
+		px[i] = hitLeft ? leftFace : (hitRight ? rightFace : px[i]);
+		pvx[i] = (hitLeft | hitRight) ? -pvx[i] : pvx[i];
+		paddleHits += hitLeft | hitRight;
+	}
+	stats.wallHits = wallHits;
+	stats.paddleHits = paddleHits;
+
+	for (size_t i = 0; i < count; i++) {
+		if (px[i] < 0.0f || px[i] > courtWidth) {
+			Respawn(i);
+			stats.goals++;
+		}
+	}
+
+	return stats;
+}
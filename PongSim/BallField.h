@@ -0,0 +1,55 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "Simulation.h"
+#include "Random.h"
+
+//Many balls stored as structure of arrays so each pass over them is a tight, cache friendly loop.
+//Used for the multi-ball stress mode and as a CPU throughput benchmark. Balls bounce off the walls
+//and the two paddles of a Match but not off each other, and respawn at the centre after a goal.
+class BallField {
+public:
+	struct Stats {
+		size_t wallHits = 0;
+		size_t paddleHits = 0;
+		size_t goals = 0;
+	};
+
+	BallField(const MatchConfig& config = MatchConfig(), float radius = 3.0f, uint64_t seed = 0);
+
+	void Spawn(size_t count);
+	void Clear();
+
+	//Paddle positions are the top of each paddle, as in PaddleState
+	Stats Step(float leftPaddleY, float rightPaddleY, float deltaTime);
+
+	size_t Size() const { return x.size(); }
+	float GetRadius() const { return radius; }
+
+	const float* X() const { return x.data(); }
+	const float* Y() const { return y.data(); }
+
+private:
+	void Respawn(size_t index);
+
+	float courtWidth;
+	float courtHeight;
+	float paddleWidth;
+	float paddleHeight;
+	float leftPaddleX;
+	float rightPaddleX;
+	float ballSpeed;
+	float radius;
+
+	Rng rng;
+
+	//Top left corner of each ball's bounding box and its velocity
+	std::vector<float> x;
+	std::vector<float> y;
+	std::vector<float> vx;
+	std::vector<float> vy;
+
+	//Contact masks from TestContacts, reused between steps to avoid reallocating
+	std::vector<uint8_t> contacts;
+};
@@ -0,0 +1,156 @@
+#pragma once
+#include "Simulation.h"
+
+//Continuous collision helpers used by the match simulation. All sweeps take a start point and
+//the full movement for the step and report the time of impact as a fraction of that movement.
+
+struct SweepHit {
+	Real time = 1.0f;
+	Vec2 normal;
+};
+
+inline Real Clamp(Real value, Real low, Real high) {
+	return value < low ? low : (value > high ? high : value);
+}
+
+//Earliest t in [0, 1] at which a point moving by delta is radius away from corner
+inline bool SweepPointCircle(Vec2 start, Vec2 delta, Vec2 corner, Real radius, Real& time) {
+	Vec2 offset = { start.x - corner.x, start.y - corner.y };
+
+	Real a = delta.x * delta.x + delta.y * delta.y;
+	Real b = offset.x * delta.x + offset.y * delta.y;
+	Real c = offset.x * offset.x + offset.y * offset.y - radius * radius;
+
+	if (a <= 0.0f || b >= 0.0f) return false;
+
+	Real discriminant = b * b - a * c;
+	if (discriminant < 0.0f) return false;
+
+	Real t = (-b - Sqrt(discriminant)) / a;
+	if (t < 0.0f || t > 1.0f) return false;
+
+	time = t;
+	return true;
+}
+
+//Circle of radius moving its centre by delta against a static box. Only reports contacts where the
+//circle is moving into the surface, so a ball resting against a face after a bounce is not hit again.
+inline bool SweepCircleAabb(Vec2 centre, Vec2 delta, Real radius, const Aabb& box, SweepHit& hit) {
+	//Already overlapping, e.g. a paddle moved into the ball: resolve immediately
+	Vec2 nearest = { Clamp(centre.x, box.left, box.right), Clamp(centre.y, box.top, box.bottom) };
+	Vec2 away = { centre.x - nearest.x, centre.y - nearest.y };
+	Real distanceSq = away.x * away.x + away.y * away.y;
+
+	if (distanceSq < radius * radius) {
+		Vec2 normal;
+		if (distanceSq > 0.0f) {
+			Real length = Sqrt(distanceSq);
+			normal = { away.x / length, away.y / length };
+		}
+		else {
+			//Centre is inside the box, push out along the shallowest axis
+			Real pushX = centre.x - box.left < box.right - centre.x ? -(centre.x - box.left) : box.right - centre.x;
+			Real pushY = centre.y - box.top < box.bottom - centre.y ? -(centre.y - box.top) : box.bottom - centre.y;
+			if (Abs(pushX) < Abs(pushY))
+				normal = { pushX < 0.0f ? -1.0f : 1.0f, 0.0f };
+			else
+				normal = { 0.0f, pushY < 0.0f ? -1.0f : 1.0f };
+		}
+
+		if (delta.x * normal.x + delta.y * normal.y >= 0.0f) return false;
+
+		hit.time = 0.0f;
+		hit.normal = normal;
+		return true;
+	}
+
+	//Ray against the box grown by the radius
+	Aabb grown = { box.left - radius, box.top - radius, box.right + radius, box.bottom + radius };
+
+	Real enter = 0.0f;
+	Real exit = 1.0f;
+	Vec2 normal;
+
+	if (delta.x == 0.0f) {
+		if (centre.x < grown.left || centre.x > grown.right) return false;
+	}
+	else {
+		Real tNear = ((delta.x > 0.0f ? grown.left : grown.right) - centre.x) / delta.x;
+		Real tFar = ((delta.x > 0.0f ? grown.right : grown.left) - centre.x) / delta.x;
+		if (tNear > enter) {
+			enter = tNear;
+			normal = { delta.x > 0.0f ? -1.0f : 1.0f, 0.0f };
+		}
+		if (tFar < exit) exit = tFar;
+	}
+
+	if (delta.y == 0.0f) {
+		if (centre.y < grown.top || centre.y > grown.bottom) return false;
+	}
+	else {
+		Real tNear = ((delta.y > 0.0f ? grown.top : grown.bottom) - centre.y) / delta.y;
+		Real tFar = ((delta.y > 0.0f ? grown.bottom : grown.top) - centre.y) / delta.y;
+		if (tNear > enter) {
+			enter = tNear;
+			normal = { 0.0f, delta.y > 0.0f ? -1.0f : 1.0f };
+		}
+		if (tFar < exit) exit = tFar;
+	}
+
+	if (enter > exit) return false;
+
+	//The grown box has square corners but the real shape is rounded there
+	Vec2 contact = { centre.x + delta.x * enter, centre.y + delta.y * enter };
+	bool outsideX = contact.x < box.left || contact.x > box.right;
+	bool outsideY = contact.y < box.top || contact.y > box.bottom;
+
+	if (outsideX && outsideY) {
+		Vec2 corner = { contact.x < box.left ? box.left : box.right, contact.y < box.top ? box.top : box.bottom };
+
+		//The corner can only be touched while inside the grown box, so only that stretch is swept.
+		//It is never much longer than the box, which keeps the quadratic's products well within
+		//Fixed's range however long the whole movement is.
+		Real span = exit - enter;
+		Vec2 inside = { delta.x * span, delta.y * span };
+
+		//The stretch starts on the grown box's edge, a radius from the corner, and rounding can put
+		//it a hair inside. Then the corner is already touching if the ball is heading toward it.
+		Vec2 offset = { contact.x - corner.x, contact.y - corner.y };
+		Real time = enter;
+		if (offset.x * offset.x + offset.y * offset.y > radius * radius) {
+			if (!SweepPointCircle(contact, inside, corner, radius, time)) return false;
+			time = enter + time * span;
+		}
+		else if (offset.x * delta.x + offset.y * delta.y >= 0.0f) {
+			return false;
+		}
+
+		Vec2 atImpact = { centre.x + delta.x * time - corner.x, centre.y + delta.y * time - corner.y };
+		Real length = Sqrt(atImpact.x * atImpact.x + atImpact.y * atImpact.y);
+		if (length <= 0.0f) return false;
+
+		hit.time = time;
+		hit.normal = { atImpact.x / length, atImpact.y / length };
+		return true;
+	}
+
+	//Started inside the grown box without touching the real shape or entering it
+	if (normal.x == 0.0f && normal.y == 0.0f) return false;
+
+	hit.time = enter;
+	hit.normal = normal;
+	return true;
+}
+
+//Circle moving against a horizontal wall at y = wallY, facing down (normalY = 1) or up (normalY = -1)
+inline bool SweepCircleWall(Vec2 centre, Vec2 delta, Real radius, Real wallY, Real normalY, SweepHit& hit) {
+	if (delta.y * normalY >= 0.0f) return false;
+
+	Real contactY = wallY + radius * normalY;
+	Real time = (contactY - centre.y) / delta.y;
+	if (time > 1.0f) return false;
+
+	hit.time = time < 0.0f ? 0.0f : time;
+	hit.normal = { 0.0f, normalY };
+	return true;
+}
@@ -0,0 +1,118 @@
+#include "CollisionKernels.h"
+#include <cassert>
+#include <cstring>
+
+#if defined(__AVX2__)
+#define PONG_KERNEL_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PONG_KERNEL_SSE2
+#include <emmintrin.h>
+#endif
+
+void TestContactsScalar(const float* x, const float* y, size_t count, float size, float minY, float maxY,
+	const KernelBox* boxes, int boxCount, uint8_t* contacts) {
+	assert(boxCount >= 0 && boxCount <= MaxKernelBoxes);
+	for (size_t i = 0; i < count; i++) {
+		float right = x[i] + size;
+		float bottom = y[i] + size;
+
+		uint8_t bits = 0;
+		if (y[i] < minY) bits |= ContactTopWall;
+		if (y[i] > maxY) bits |= ContactBottomWall;
+
+		for (int k = 0; k < boxCount; k++) {
+			const KernelBox& box = boxes[k];
+			if (x[i] < box.right && box.left < right && y[i] < box.bottom && box.top < bottom) {
+				bits |= (uint8_t)(ContactFirstBox << k);
+			}
+		}
+
+		contacts[i] = bits;
+	}
+}
+
+#if defined(PONG_KERNEL_AVX2)
+
+void TestContacts(const float* x, const float* y, size_t count, float size, float minY, float maxY,
+	const KernelBox* boxes, int boxCount, uint8_t* contacts) {
+	assert(boxCount >= 0 && boxCount <= MaxKernelBoxes);
+	const __m256 vSize = _mm256_set1_ps(size);
+	const __m256 vMinY = _mm256_set1_ps(minY);
+	const __m256 vMaxY = _mm256_set1_ps(maxY);
+
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		__m256 left = _mm256_loadu_ps(x + i);
+		__m256 top = _mm256_loadu_ps(y + i);
+		__m256 right = _mm256_add_ps(left, vSize);
+		__m256 bottom = _mm256_add_ps(top, vSize);
+
+		__m256i bits = _mm256_and_si256(_mm256_castps_si256(_mm256_cmp_ps(top, vMinY, _CMP_LT_OQ)), _mm256_set1_epi32(ContactTopWall));
+		bits = _mm256_or_si256(bits, _mm256_and_si256(_mm256_castps_si256(_mm256_cmp_ps(top, vMaxY, _CMP_GT_OQ)), _mm256_set1_epi32(ContactBottomWall)));
+
+		for (int k = 0; k < boxCount; k++) {
+			const KernelBox& box = boxes[k];
+			__m256 overlapX = _mm256_and_ps(_mm256_cmp_ps(left, _mm256_set1_ps(box.right), _CMP_LT_OQ), _mm256_cmp_ps(_mm256_set1_ps(box.left), right, _CMP_LT_OQ));
+			__m256 overlapY = _mm256_and_ps(_mm256_cmp_ps(top, _mm256_set1_ps(box.bottom), _CMP_LT_OQ), _mm256_cmp_ps(_mm256_set1_ps(box.top), bottom, _CMP_LT_OQ));
+			__m256i overlap = _mm256_castps_si256(_mm256_and_ps(overlapX, overlapY));
+			bits = _mm256_or_si256(bits, _mm256_and_si256(overlap, _mm256_set1_epi32(ContactFirstBox << k)));
+		}
+
+		__m128i words = _mm_packs_epi32(_mm256_castsi256_si128(bits), _mm256_extracti128_si256(bits, 1));
+		_mm_storel_epi64((__m128i*)(contacts + i), _mm_packus_epi16(words, words));
+	}
+
+	TestContactsScalar(x + i, y + i, count - i, size, minY, maxY, boxes, boxCount, contacts + i);
+}
+
+const char* ContactKernelName() { return "AVX2"; }
+
+#elif defined(PONG_KERNEL_SSE2)
+
+void TestContacts(const float* x, const float* y, size_t count, float size, float minY, float maxY,
+	const KernelBox* boxes, int boxCount, uint8_t* contacts) {
+	assert(boxCount >= 0 && boxCount <= MaxKernelBoxes);
+	const __m128 vSize = _mm_set1_ps(size);
+	const __m128 vMinY = _mm_set1_ps(minY);
+	const __m128 vMaxY = _mm_set1_ps(maxY);
+
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		__m128 left = _mm_loadu_ps(x + i);
+		__m128 top = _mm_loadu_ps(y + i);
+		__m128 right = _mm_add_ps(left, vSize);
+		__m128 bottom = _mm_add_ps(top, vSize);
+
+		__m128i bits = _mm_and_si128(_mm_castps_si128(_mm_cmplt_ps(top, vMinY)), _mm_set1_epi32(ContactTopWall));
+		bits = _mm_or_si128(bits, _mm_and_si128(_mm_castps_si128(_mm_cmpgt_ps(top, vMaxY)), _mm_set1_epi32(ContactBottomWall)));
+
+		for (int k = 0; k < boxCount; k++) {
+			const KernelBox& box = boxes[k];
+			__m128 overlapX = _mm_and_ps(_mm_cmplt_ps(left, _mm_set1_ps(box.right)), _mm_cmplt_ps(_mm_set1_ps(box.left), right));
+			__m128 overlapY = _mm_and_ps(_mm_cmplt_ps(top, _mm_set1_ps(box.bottom)), _mm_cmplt_ps(_mm_set1_ps(box.top), bottom));
+			__m128i overlap = _mm_castps_si128(_mm_and_ps(overlapX, overlapY));
+			bits = _mm_or_si128(bits, _mm_and_si128(overlap, _mm_set1_epi32(ContactFirstBox << k)));
+		}
+
+		__m128i words = _mm_packs_epi32(bits, bits);
+		int packed = _mm_cvtsi128_si32(_mm_packus_epi16(words, words));
+		memcpy(contacts + i, &packed, 4);
+	}
+
+	TestContactsScalar(x + i, y + i, count - i, size, minY, maxY, boxes, boxCount, contacts + i);
+}
+
+const char* ContactKernelName() { return "SSE2"; }
+
+#else
+
+void TestContacts(const float* x, const float* y, size_t count, float size, float minY, float maxY,
+	const KernelBox* boxes, int boxCount, uint8_t* contacts) {
+	assert(boxCount >= 0 && boxCount <= MaxKernelBoxes);
+	TestContactsScalar(x, y, count, size, minY, maxY, boxes, boxCount, contacts);
+}
+
+const char* ContactKernelName() { return "scalar"; }
+
+#endif
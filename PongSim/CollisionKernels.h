@@ -0,0 +1,36 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+//Batched overlap tests for many equally sized square boxes (the balls of a BallField) against the
+//court walls and a few static boxes (the paddles). Builds with AVX2 use 8 lanes, builds with SSE2
+//use 4, anything else falls back to the scalar loop. All paths give identical masks.
+
+struct KernelBox {
+	float left;
+	float top;
+	float right;
+	float bottom;
+};
+
+enum ContactBit : uint8_t {
+	ContactTopWall = 1 << 0,
+	ContactBottomWall = 1 << 1,
+	ContactFirstBox = 1 << 2
+};
+
+//Past this the box bits no longer fit a uint8_t, and the SIMD paths (which saturate) and the
+//scalar loop (which truncates) would disagree. Every entry point asserts it.
+static const int MaxKernelBoxes = 6;
+
+//For each box (x[i], y[i], size, size) writes a ContactBit mask to contacts[i]: the top wall bit when
+//y < minY, the bottom wall bit when y > maxY and ContactFirstBox << k when it overlaps boxes[k]
+//using the same test as sf::Rect::intersects.
+void TestContacts(const float* x, const float* y, size_t count, float size, float minY, float maxY,
+	const KernelBox* boxes, int boxCount, uint8_t* contacts);
+
+//Reference implementation, also used for the tail of the SIMD loops
+void TestContactsScalar(const float* x, const float* y, size_t count, float size, float minY, float maxY,
+	const KernelBox* boxes, int boxCount, uint8_t* contacts);
+
+const char* ContactKernelName();
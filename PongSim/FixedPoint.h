@@ -0,0 +1,80 @@
+#pragma once
+#include <cstdint>
+
+//Fixed point number with 16 fractional bits. Every operation is plain integer arithmetic so
+//results are bit-identical across compilers, optimisation levels and CPUs. The raw value is
+//64 bits wide, but a product is formed before shifting back down, so it overflows once the two
+//values multiplied come to more than about 2^31 (2.1e9). Products of court-sized distances fit
+//easily, so the collision code keeps the inputs to higher order terms, like a sweep's quadratic, short.
+class Fixed {
+public:
+	static const int FractionBits = 16;
+	static const int64_t One = (int64_t)1 << FractionBits;
+
+	constexpr Fixed() : raw(0) {}
+	constexpr Fixed(int value) : raw((int64_t)value * One) {}
+	constexpr Fixed(float value) : raw((int64_t)(value * (float)One)) {}
+	constexpr Fixed(double value) : raw((int64_t)(value * (double)One)) {}
+
+	static constexpr Fixed FromRaw(int64_t raw) { return Fixed(raw, RawTag()); }
+
+	constexpr int64_t Raw() const { return raw; }
+	constexpr float ToFloat() const { return (float)raw / (float)One; }
+	constexpr int ToInt() const { return (int)(raw >> FractionBits); }
+
+	Fixed& operator+=(Fixed other) { raw += other.raw; return *this; }
+	Fixed& operator-=(Fixed other) { raw -= other.raw; return *this; }
+	Fixed& operator*=(Fixed other) { raw = (raw * other.raw) >> FractionBits; return *this; }
+	Fixed& operator/=(Fixed other) { raw = other.raw == 0 ? 0 : (raw * One) / other.raw; return *this; }
+
+	constexpr Fixed operator-() const { return FromRaw(-raw); }
+
+	friend constexpr Fixed operator+(Fixed a, Fixed b) { return FromRaw(a.raw + b.raw); }
+	friend constexpr Fixed operator-(Fixed a, Fixed b) { return FromRaw(a.raw - b.raw); }
+	friend constexpr Fixed operator*(Fixed a, Fixed b) { return FromRaw((a.raw * b.raw) >> FractionBits); }
+	friend constexpr Fixed operator/(Fixed a, Fixed b) { return FromRaw(b.raw == 0 ? 0 : (a.raw * One) / b.raw); }
+
+	friend constexpr bool operator==(Fixed a, Fixed b) { return a.raw == b.raw; }
+	friend constexpr bool operator!=(Fixed a, Fixed b) { return a.raw != b.raw; }
+	friend constexpr bool operator<(Fixed a, Fixed b) { return a.raw < b.raw; }
+	friend constexpr bool operator>(Fixed a, Fixed b) { return a.raw > b.raw; }
+	friend constexpr bool operator<=(Fixed a, Fixed b) { return a.raw <= b.raw; }
+	friend constexpr bool operator>=(Fixed a, Fixed b) { return a.raw >= b.raw; }
+
+private:
+	struct RawTag {};
+	constexpr Fixed(int64_t raw, RawTag) : raw(raw) {}
+
+	int64_t raw;
+};
+
+inline Fixed Abs(Fixed value) {
+	return value < Fixed() ? -value : value;
+}
+
+//Integer square root of the raw value scaled up by the fraction bits, rounded down
+inline Fixed Sqrt(Fixed value) {
+	if (value.Raw() <= 0) return Fixed();
+
+	uint64_t remainder = (uint64_t)value.Raw() << Fixed::FractionBits;
+	uint64_t root = 0;
+	uint64_t bit = (uint64_t)1 << 62;
+
+	while (bit > remainder) bit >>= 2;
+
+	while (bit != 0) {
+		if (remainder >= root + bit) {
+			remainder -= root + bit;
+			root = (root >> 1) + bit;
+		}
+		else {
+			root >>= 1;
+		}
+		bit >>= 2;
+	}
+
+	return Fixed::FromRaw((int64_t)root);
+}
+
+inline float ToFloat(Fixed value) { return value.ToFloat(); }
+inline int ToInt(Fixed value) { return value.ToInt(); }
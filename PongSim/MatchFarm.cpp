@@ -0,0 +1,144 @@
+#include "MatchFarm.h"
+#include <thread>
+#include <chrono>
+
+MatchFarm::MatchFarm(const FarmConfig& config, const std::vector<AiSettings>& controllers) : config(config), controllers(controllers), completed(0) {
+
+}
+
+std::vector<MatchJob> MatchFarm::RoundRobin(int gamesPerPair, uint64_t seed) const {
+	std::vector<MatchJob> jobs;
+	uint32_t count = (uint32_t)controllers.size();
+
+	for (uint32_t left = 0; left < count; left++) {
+		for (uint32_t right = 0; right < count; right++) {
+			if (left == right) continue;
+
+			for (int game = 0; game < gamesPerPair; game++) {
+				jobs.push_back({ left, right, seed + jobs.size() });
+			}
+		}
+	}
+	return jobs;
+}
+
+MatchResult MatchFarm::PlayMatch(const FarmConfig& config, const AiSettings& left, const AiSettings& right, uint64_t seed) {
+	Match match(config.match, seed);
+	AiController leftAi(PaddleSide::Left, left, seed * 2 + 1);
+	AiController rightAi(PaddleSide::Right, right, seed * 2 + 2);
+
+	MatchResult result;
+	int maxDecisions = (int)(config.maxMatchSeconds / ToFloat(config.decisionInterval));
+
+	for (int i = 0; i < maxDecisions; i++) {
+		const MatchState& state = match.GetState();
+		PaddleInput leftInput = leftAi.Decide(state, config.match, config.decisionInterval);
+		PaddleInput rightInput = rightAi.Decide(state, config.match, config.decisionInterval);
+
+		MatchTally tally;
+		match.FastForward(leftInput, rightInput, config.decisionInterval, &tally);
+
+		//A ball leaving on the right is a point for the left player and vice versa
+		result.leftPoints += tally.rightGoals;
+		result.rightPoints += tally.leftGoals;
+
+		if (result.leftPoints >= config.pointsToWin || result.rightPoints >= config.pointsToWin) break;
+	}
+
+	return result;
+}
+
+FarmReport MatchFarm::Run(const std::vector<MatchJob>& jobs) {
+	FarmReport report;
+	report.results.resize(jobs.size());
+	report.wins.assign(controllers.size(), 0);
+
+	jobCount = jobs.size();
+	completed = 0;
+
+	//Start with an even split; stealing evens out matches that run long
+	workerCount = config.threadCount > 0 ? config.threadCount : 1;
+	ranges.reset(new WorkerRange[workerCount]);
+	for (int worker = 0; worker < workerCount; worker++) {
+		uint32_t begin = (uint32_t)(jobCount * worker / workerCount);
+		uint32_t end = (uint32_t)(jobCount * (worker + 1) / workerCount);
+		ranges[worker].range.store(Pack(begin, end));
+	}
+
+	auto start = std::chrono::steady_clock::now();
+
+	std::vector<std::thread> threads;
+	for (int worker = 1; worker < workerCount; worker++) {
+		threads.emplace_back(&MatchFarm::WorkerLoop, this, worker, std::cref(jobs), std::ref(report.results));
+	}
+	WorkerLoop(0, jobs, report.results);
+
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+
+	report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	report.matchesPerSecond = report.seconds > 0.0 ? jobCount / report.seconds : 0.0;
+
+	for (size_t i = 0; i < jobs.size(); i++) {
+		const MatchResult& result = report.results[i];
+		if (result.leftPoints > result.rightPoints) report.wins[jobs[i].leftController]++;
+		else if (result.rightPoints > result.leftPoints) report.wins[jobs[i].rightController]++;
+	}
+
+	return report;
+}
+
+void MatchFarm::WorkerLoop(int worker, const std::vector<MatchJob>& jobs, std::vector<MatchResult>& results) {
+	while (completed.load(std::memory_order_acquire) < jobCount) {
+		uint32_t begin;
+		uint32_t end;
+
+		if (TakeOwn(worker, begin, end)) {
+			for (uint32_t i = begin; i < end; i++) {
+				const MatchJob& job = jobs[i];
+				results[i] = PlayMatch(config, controllers[job.leftController], controllers[job.rightController], job.seed);
+			}
+			completed.fetch_add(end - begin, std::memory_order_release);
+		}
+		else if (!Steal(worker)) {
+			std::this_thread::yield();
+		}
+	}
+}
+
+bool MatchFarm::TakeOwn(int worker, uint32_t& begin, uint32_t& end) {
+	std::atomic<uint64_t>& own = ranges[worker].range;
+	uint64_t range = own.load(std::memory_order_acquire);
+
+	while (Begin(range) < End(range)) {
+		uint32_t taken = Begin(range) + config.grain;
+		if (taken > End(range)) taken = End(range);
+
+		if (own.compare_exchange_weak(range, Pack(taken, End(range)), std::memory_order_acq_rel)) {
+			begin = Begin(range);
+			end = taken;
+			return true;
+		}
+	}
+	return false;
+}
+
+bool MatchFarm::Steal(int worker) {
+	for (int offset = 1; offset < workerCount; offset++) {
+		std::atomic<uint64_t>& victim = ranges[(worker + offset) % workerCount].range;
+		uint64_t range = victim.load(std::memory_order_acquire);
+
+		while (Begin(range) < End(range)) {
+			//Leave the front half to its owner and take the back half
+			uint32_t middle = Begin(range) + (End(range) - Begin(range)) / 2;
+
+			if (victim.compare_exchange_weak(range, Pack(Begin(range), middle), std::memory_order_acq_rel)) {
+				//Only this worker ever stores into its own range, and only once it is empty
+				ranges[worker].range.store(Pack(middle, End(range)), std::memory_order_release);
+				return true;
+			}
+		}
+	}
+	return false;
+}
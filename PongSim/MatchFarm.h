@@ -0,0 +1,80 @@
+#pragma once
+#include <vector>
+#include <atomic>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include "Simulation.h"
+#include "AiController.h"
+
+struct MatchJob {
+	uint32_t leftController;
+	uint32_t rightController;
+	uint64_t seed;
+};
+
+struct MatchResult {
+	int leftPoints = 0;
+	int rightPoints = 0;
+};
+
+struct FarmConfig {
+	MatchConfig match;
+
+	//Controllers re-decide and the match is fast-forwarded in steps of this length
+	Real decisionInterval = 1.0f / 60.0f;
+
+	int pointsToWin = 5;
+	float maxMatchSeconds = 300.0f;
+
+	int threadCount = 1;
+
+	//Jobs a worker takes from its own range at a time
+	uint32_t grain = 16;
+};
+
+struct FarmReport {
+	std::vector<MatchResult> results;
+	std::vector<int> wins;
+	double seconds = 0.0;
+	double matchesPerSecond = 0.0;
+};
+
+//Plays headless matches between AiControllers across all cores. Each worker owns a range of job
+//indices and takes jobs from its front; an idle worker steals the back half of another worker's
+//range. Ranges are single atomics, so scheduling never takes a lock, and each result is written
+//to its own slot so collecting them doesn't either.
+class MatchFarm {
+public:
+	MatchFarm(const FarmConfig& config, const std::vector<AiSettings>& controllers);
+
+	//Every controller plays every other controller gamesPerPair times on each side
+	std::vector<MatchJob> RoundRobin(int gamesPerPair, uint64_t seed) const;
+
+	FarmReport Run(const std::vector<MatchJob>& jobs);
+
+	static MatchResult PlayMatch(const FarmConfig& config, const AiSettings& left, const AiSettings& right, uint64_t seed);
+
+private:
+	//Begin and end of a worker's remaining job indices packed into one word so both change together.
+	//Each on its own cache line so stealing from one worker doesn't slow down its neighbours.
+	struct alignas(64) WorkerRange {
+		std::atomic<uint64_t> range;
+	};
+
+	static uint64_t Pack(uint32_t begin, uint32_t end) { return ((uint64_t)begin << 32) | end; }
+	static uint32_t Begin(uint64_t range) { return (uint32_t)(range >> 32); }
+	static uint32_t End(uint64_t range) { return (uint32_t)range; }
+
+	void WorkerLoop(int worker, const std::vector<MatchJob>& jobs, std::vector<MatchResult>& results);
+	bool TakeOwn(int worker, uint32_t& begin, uint32_t& end);
+	bool Steal(int worker);
+
+	FarmConfig config;
+	std::vector<AiSettings> controllers;
+
+	std::unique_ptr<WorkerRange[]> ranges;
+	int workerCount = 1;
+	std::atomic<size_t> completed;
+	size_t jobCount = 0;
+};
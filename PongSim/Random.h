@@ -0,0 +1,58 @@
+#pragma once
+#include <cstdint>
+
+//PCG32 (XSH RR variant). Small, fast and fully determined by its two state words, so each match
+//can own one, seed it explicitly and store it with the rest of its state.
+class Rng {
+public:
+	Rng(uint64_t seed = 0x853c49e6748fea9bULL, uint64_t stream = 0xda3e39cb94b95bdbULL) {
+		Seed(seed, stream);
+	}
+
+	void Seed(uint64_t seed, uint64_t stream = 0xda3e39cb94b95bdbULL) {
+		state = 0;
+		increment = (stream << 1) | 1;
+		Next();
+		state += seed;
+		Next();
+	}
+
+	uint32_t Next() {
+		uint64_t old = state;
+		state = old * 6364136223846793005ULL + increment;
+
+		uint32_t shifted = (uint32_t)(((old >> 18) ^ old) >> 27);
+		uint32_t rotation = (uint32_t)(old >> 59);
+		return (shifted >> rotation) | (shifted << ((0u - rotation) & 31));
+	}
+
+	//Uniform in [0, bound) without modulo bias
+	uint32_t NextBelow(uint32_t bound) {
+		if (bound == 0) return 0;
+
+		uint32_t threshold = (0u - bound) % bound;
+		while (true) {
+			uint32_t value = Next();
+			if (value >= threshold) return value % bound;
+		}
+	}
+
+	//Uniform in [0, 1)
+	float NextFloat() {
+		return (Next() >> 8) * (1.0f / 16777216.0f);
+	}
+
+	bool NextBool() {
+		return (Next() & 1) != 0;
+	}
+
+	uint64_t GetState() const { return state; }
+	uint64_t GetIncrement() const { return increment; }
+
+	friend bool operator==(const Rng& a, const Rng& b) { return a.state == b.state && a.increment == b.increment; }
+	friend bool operator!=(const Rng& a, const Rng& b) { return !(a == b); }
+
+private:
+	uint64_t state;
+	uint64_t increment;
+};
@@ -0,0 +1,302 @@
+#include "Simulation.h"
+#include "Collision.h"
+
+//A ball can touch at most this many surfaces in one step before the rest of its movement is dropped
+static const int MaxBallContacts = 4;
+
+//FastForward has no ticks, so it allows the same number of contacts per this much time instead:
+//one tick at the default 120Hz
+static const float ContactWindow = 1.0f / 120.0f;
+
+Match::Match(const MatchConfig& config, uint64_t seed) : config(config) {
+	Seed(seed);
+	Reset();
+}
+
+void Match::Seed(uint64_t seed, uint64_t stream) {
+	state.rng.Seed(seed, stream);
+}
+
+void Match::Reset() {
+	Rng rng = state.rng;
+	state = MatchState();
+	state.rng = rng;
+	state.left.y = config.courtHeight / 2;
+	state.right.y = config.courtHeight / 2;
+	ResetBall();
+}
+
+void Match::ResetBall() {
+	BallState& ball = state.ball;
+	ball.position = { config.courtWidth / 2, config.courtHeight / 2 };
+
+	Real xVel = state.rng.NextBool() ? config.ballSpeed : -config.ballSpeed;
+	Real yVel = Real((int)state.rng.NextBelow(ToInt(config.ballSpeed)));
+
+	ball.velocity = { xVel, yVel };
+}
+
+uint32_t Match::Step(PaddleInput leftInput, PaddleInput rightInput, Real deltaTime) {
+	MovePaddle(state.left, leftInput, deltaTime);
+	MovePaddle(state.right, rightInput, deltaTime);
+
+	uint32_t events = MoveBall(deltaTime);
+
+	if (state.ball.position.x < 0) {
+		state.left.score = 0;
+		events |= EventLeftGoal;
+		ResetBall();
+	}
+	else if (state.ball.position.x > config.courtWidth) {
+		state.right.score = 0;
+		events |= EventRightGoal;
+		ResetBall();
+	}
+
+	state.tick++;
+	return events;
+}
+
+void Match::MovePaddle(PaddleState& paddle, PaddleInput input, Real deltaTime) {
+	//Stops exactly at the walls, so the paddle ends up in the same place at any tick rate
+	paddle.y = PaddleAfter(paddle, input, deltaTime);
+}
+
+uint32_t Match::MoveBall(Real deltaTime) {
+	BallState& ball = state.ball;
+	uint32_t events = EventNone;
+	Real radius = config.ballRadius;
+
+	Aabb leftBox = PaddleBox(state.left, config.leftPaddleX);
+	Aabb rightBox = PaddleBox(state.right, config.rightPaddleX);
+
+	//Sweep the ball along its path, bouncing at the exact time of each contact and
+	//spending the rest of the step's movement on the new heading
+	Real remaining = deltaTime;
+	for (int i = 0; i < MaxBallContacts && remaining > 0.0f; i++) {
+		Vec2 centre = { ball.position.x + radius, ball.position.y + radius };
+		Vec2 delta = { ball.velocity.x * remaining, ball.velocity.y * remaining };
+
+		SweepHit first;
+		SweepHit hit;
+		PaddleState* paddleHit = nullptr;
+		bool wallHit = false;
+
+		if (SweepCircleWall(centre, delta, radius, 0.0f, 1.0f, hit) && hit.time < first.time) {
+			first = hit;
+			wallHit = true;
+		}
+		if (SweepCircleWall(centre, delta, radius, config.courtHeight, -1.0f, hit) && hit.time < first.time) {
+			first = hit;
+			wallHit = true;
+		}
+		if (SweepCircleAabb(centre, delta, radius, leftBox, hit) && hit.time < first.time) {
+			first = hit;
+			wallHit = false;
+			paddleHit = &state.left;
+		}
+		if (SweepCircleAabb(centre, delta, radius, rightBox, hit) && hit.time < first.time) {
+			first = hit;
+			wallHit = false;
+			paddleHit = &state.right;
+		}
+
+		ball.position.x += delta.x * first.time;
+		ball.position.y += delta.y * first.time;
+
+		if (!wallHit && paddleHit == nullptr) break;
+
+		remaining -= remaining * first.time;
+
+		if (wallHit) {
+			ball.velocity.y = -ball.velocity.y;
+			events |= EventWallHit;
+		}
+		else {
+			HitPaddle(*paddleHit, first.normal);
+			events |= paddleHit == &state.left ? EventLeftPaddleHit : EventRightPaddleHit;
+		}
+	}
+
+	return events;
+}
+
+Aabb Match::PaddleBox(const PaddleState& paddle, Real paddleX) const {
+	return { paddleX, paddle.y, paddleX + config.paddleWidth, paddle.y + config.paddleHeight };
+}
+
+void Match::HitPaddle(PaddleState& paddle, Vec2 normal) {
+	BallState& ball = state.ball;
+
+	if (Abs(normal.x) >= Abs(normal.y)) {
+		//Face hits send the ball back with a new random vertical speed
+		Real xSpeed = Abs(ball.velocity.x);
+		ball.velocity = { normal.x > 0.0f ? xSpeed : -xSpeed, Real(-(int)state.rng.NextBelow(ToInt(config.ballSpeed))) };
+	}
+	else {
+		//Glancing hits on the paddle ends reflect like a wall
+		Real along = ball.velocity.x * normal.x + ball.velocity.y * normal.y;
+		ball.velocity.x -= 2.0f * along * normal.x;
+		ball.velocity.y -= 2.0f * along * normal.y;
+	}
+
+	paddle.score++;
+}
+
+Real Match::PaddleAfter(const PaddleState& paddle, PaddleInput input, Real time) const {
+	if (input == PaddleInput::Idle) return paddle.y;
+
+	Real moved = paddle.y + config.paddleSpeed * Real((int)input) * time;
+	return Clamp(moved, Real(0), config.courtHeight - config.paddleHeight);
+}
+
+Real Match::PaddleVelocity(const PaddleState& paddle, PaddleInput input) const {
+	if (input == PaddleInput::Up && paddle.y > Real(0)) return -config.paddleSpeed;
+	if (input == PaddleInput::Down && paddle.y < config.courtHeight - config.paddleHeight) return config.paddleSpeed;
+	return 0;
+}
+
+uint32_t Match::FastForward(PaddleInput leftInput, PaddleInput rightInput, Real duration, MatchTally* tally) {
+	BallState& ball = state.ball;
+	Real radius = config.ballRadius;
+	uint32_t events = EventNone;
+
+	//A paddle end closing on a wall can pin the ball against it, bouncing it back and forth ever
+	//faster. Past MaxBallContacts in a window the paddles are skipped until the window ends, as
+	//Step does by dropping the rest of a tick's movement.
+	int windowContacts = 0;
+	Real windowLeft = ContactWindow;
+
+	Real remaining = duration;
+	while (remaining > Real(0)) {
+		Vec2 centre = { ball.position.x + radius, ball.position.y + radius };
+
+		//Time until the ball's centre reaches the wall it is heading toward
+		Real untilWall = remaining + Real(1);
+		if (ball.velocity.y < Real(0)) {
+			untilWall = (radius - centre.y) / ball.velocity.y;
+		}
+		else if (ball.velocity.y > Real(0)) {
+			untilWall = (config.courtHeight - radius - centre.y) / ball.velocity.y;
+		}
+
+		//A goal is scored once the bounding box's left edge passes 0 or passes the court width
+		bool headingLeft = ball.velocity.x < Real(0);
+		Real goalLine = headingLeft ? Real(0) : config.courtWidth;
+		Real untilGoal = ball.velocity.x != Real(0) ? (goalLine - ball.position.x) / ball.velocity.x : remaining + Real(1);
+
+		if (untilWall < Real(0)) untilWall = 0;
+		if (untilGoal < Real(0)) untilGoal = 0;
+
+		enum { ContactNone, ContactWall, ContactPaddle, ContactGoal } contact = ContactNone;
+		Real next = remaining;
+		if (untilWall <= next) {
+			next = untilWall;
+			contact = ContactWall;
+		}
+		if (untilGoal < next) {
+			next = untilGoal;
+			contact = ContactGoal;
+		}
+
+		//Paddles move at a constant speed until they reach a wall, so end the interval there
+		Real leftVelocity = PaddleVelocity(state.left, leftInput);
+		Real rightVelocity = PaddleVelocity(state.right, rightInput);
+		Real maxY = config.courtHeight - config.paddleHeight;
+		Real paddleStops[2] = {
+			leftVelocity < Real(0) ? state.left.y / -leftVelocity : (leftVelocity > Real(0) ? (maxY - state.left.y) / leftVelocity : next),
+			rightVelocity < Real(0) ? state.right.y / -rightVelocity : (rightVelocity > Real(0) ? (maxY - state.right.y) / rightVelocity : next)
+		};
+		for (Real stop : paddleStops) {
+			if (stop < next) {
+				next = stop;
+				contact = ContactNone;
+			}
+		}
+
+		//Within the interval both paddles move in straight lines, so sweep the ball against each
+		//in the paddle's own frame: the same rounded box test Step uses
+		PaddleState* paddleHit = nullptr;
+		SweepHit first;
+		if (windowContacts < MaxBallContacts) {
+			SweepHit hit;
+			Vec2 leftDelta = { ball.velocity.x * next, (ball.velocity.y - leftVelocity) * next };
+			Vec2 rightDelta = { ball.velocity.x * next, (ball.velocity.y - rightVelocity) * next };
+
+			if (SweepCircleAabb(centre, leftDelta, radius, PaddleBox(state.left, config.leftPaddleX), hit) && hit.time < first.time) {
+				first = hit;
+				paddleHit = &state.left;
+			}
+			if (SweepCircleAabb(centre, rightDelta, radius, PaddleBox(state.right, config.rightPaddleX), hit) && hit.time < first.time) {
+				first = hit;
+				paddleHit = &state.right;
+			}
+		}
+		if (paddleHit) {
+			next = next * first.time;
+			contact = ContactPaddle;
+		}
+
+		ball.position.x += ball.velocity.x * next;
+		ball.position.y += ball.velocity.y * next;
+		state.left.y = PaddleAfter(state.left, leftInput, next);
+		state.right.y = PaddleAfter(state.right, rightInput, next);
+
+		//Snap a paddle whose stop ended the interval onto the wall, as its stop time can round
+		//to nothing when it is a hair away
+		if (leftVelocity != Real(0) && paddleStops[0] <= next) state.left.y = leftVelocity < Real(0) ? Real(0) : maxY;
+		if (rightVelocity != Real(0) && paddleStops[1] <= next) state.right.y = rightVelocity < Real(0) ? Real(0) : maxY;
+		remaining -= next;
+
+		windowLeft -= next;
+		if (windowLeft <= Real(0)) {
+			windowContacts = 0;
+			windowLeft = ContactWindow;
+		}
+		if (contact == ContactWall || contact == ContactPaddle) windowContacts++;
+
+		if (contact == ContactWall) {
+			ball.velocity.y = -ball.velocity.y;
+			events |= EventWallHit;
+			if (tally) tally->wallHits++;
+		}
+		else if (contact == ContactPaddle) {
+			bool left = paddleHit == &state.left;
+			HitPaddle(*paddleHit, first.normal);
+
+			//An end or corner can catch up with a slow ball after it bounces. Let it carry the ball
+			//instead, or every following interval would start with another contact.
+			Real paddleVelocity = left ? leftVelocity : rightVelocity;
+			Real closing = ball.velocity.x * first.normal.x + (ball.velocity.y - paddleVelocity) * first.normal.y;
+			if (closing < Real(0)) {
+				ball.velocity.x -= closing * first.normal.x;
+				ball.velocity.y -= closing * first.normal.y;
+			}
+			events |= left ? EventLeftPaddleHit : EventRightPaddleHit;
+			if (tally) (left ? tally->leftPaddleHits : tally->rightPaddleHits)++;
+		}
+		else if (contact == ContactGoal) {
+			if (headingLeft) {
+				state.left.score = 0;
+				events |= EventLeftGoal;
+				if (tally) tally->leftGoals++;
+			}
+			else {
+				state.right.score = 0;
+				events |= EventRightGoal;
+				if (tally) tally->rightGoals++;
+			}
+			ResetBall();
+		}
+	}
+
+	return events;
+}
+
+uint32_t Match::FastForward(const InputSegment* segments, size_t count, MatchTally* tally) {
+	uint32_t events = EventNone;
+	for (size_t i = 0; i < count; i++) {
+		events |= FastForward(segments[i].left, segments[i].right, segments[i].duration, tally);
+	}
+	return events;
+}
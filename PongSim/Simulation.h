@@ -0,0 +1,147 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include "Random.h"
+
+//Headless match simulation. Nothing in here may depend on SFML so the same code can be
+//driven by the windowed game and by batch tools on machines without a display or sound card.
+
+#define SCREEN_WIDTH 1024
+#define SCREEN_HEIGHT 720
+
+//Define PONG_FIXED_POINT to run the simulation on Fixed instead of float. Matches are then
+//bit-identical across builds, so replays and lockstep peers only need to share inputs. The
+//library and everything that includes this header have to agree, so set it for the whole build
+//with the FixedPoint property on the solution or -DPONG_FIXED_POINT=ON with CMake.
+#ifdef PONG_FIXED_POINT
+#include "FixedPoint.h"
+typedef Fixed Real;
+#else
+typedef float Real;
+
+inline float Abs(float value) { return std::fabs(value); }
+inline float Sqrt(float value) { return std::sqrt(value); }
+inline float ToFloat(float value) { return value; }
+inline int ToInt(float value) { return (int)value; }
+#endif
+
+struct Vec2 {
+	Real x = 0.0f;
+	Real y = 0.0f;
+};
+
+struct Aabb {
+	Real left;
+	Real top;
+	Real right;
+	Real bottom;
+};
+
+struct MatchConfig {
+	Real courtWidth = SCREEN_WIDTH;
+	Real courtHeight = SCREEN_HEIGHT;
+
+	Real paddleWidth = 20.0f;
+	Real paddleHeight = 100.0f;
+	Real paddleSpeed = 120.0f;
+	Real leftPaddleX = 15.0f;
+	Real rightPaddleX = SCREEN_WIDTH - 35.0f;
+
+	Real ballRadius = 16.0f;
+	Real ballSpeed = 250.0f;
+};
+
+enum class PaddleInput : int8_t {
+	Up = -1,
+	Idle = 0,
+	Down = 1
+};
+
+//Bit flags returned by Match::Step so the front end can react (sounds, effects) without
+//the simulation knowing about it
+enum MatchEvent : uint32_t {
+	EventNone = 0,
+	EventWallHit = 1 << 0,
+	EventLeftPaddleHit = 1 << 1,
+	EventRightPaddleHit = 1 << 2,
+	EventLeftGoal = 1 << 3,
+	EventRightGoal = 1 << 4
+};
+
+//Event counts from Match::FastForward, where one call can cover many contacts and goals
+struct MatchTally {
+	int wallHits = 0;
+	int leftPaddleHits = 0;
+	int rightPaddleHits = 0;
+	int leftGoals = 0;
+	int rightGoals = 0;
+};
+
+//Both paddles' inputs held constant for a stretch of time
+struct InputSegment {
+	Real duration;
+	PaddleInput left;
+	PaddleInput right;
+};
+
+struct PaddleState {
+	Real y = SCREEN_HEIGHT / 2;
+	int score = 0;
+};
+
+//Positions are the top left corner of the object's bounding box, matching the SFML shapes
+struct BallState {
+	Vec2 position;
+	Vec2 velocity;
+};
+
+//Plain data so a whole match can be copied, stored and restored. Includes the match's random
+//generator, so a restored snapshot plays out exactly as the original did.
+struct MatchState {
+	PaddleState left;
+	PaddleState right;
+	BallState ball;
+	uint64_t tick = 0;
+	Rng rng;
+};
+
+class Match {
+public:
+	Match(const MatchConfig& config = MatchConfig(), uint64_t seed = 0);
+
+	void Seed(uint64_t seed, uint64_t stream = 0);
+
+	//Puts paddles, scores and ball back to the start; the random generator carries on
+	void Reset();
+	void ResetBall();
+
+	uint32_t Step(PaddleInput leftInput, PaddleInput rightInput, Real deltaTime);
+
+	//Event driven alternative to Step for headless runs. Jumps straight from one contact (wall,
+	//paddle, goal line) to the next instead of ticking, so a whole rally costs a handful of
+	//operations. Paddles are swept with the same rounded box test as Step, but continuously
+	//rather than moving first each tick, so individual rallies differ while wall, hit and goal
+	//rates stay within a few percent (--fast-forward-check compares them). The tick counter is
+	//not advanced.
+	uint32_t FastForward(PaddleInput leftInput, PaddleInput rightInput, Real duration, MatchTally* tally = nullptr);
+	uint32_t FastForward(const InputSegment* segments, size_t count, MatchTally* tally = nullptr);
+
+	const MatchConfig& GetConfig() const { return config; }
+	const MatchState& GetState() const { return state; }
+	void SetState(const MatchState& newState) { state = newState; }
+
+	Real BallSize() const { return config.ballRadius * 2.0f; }
+
+private:
+	void MovePaddle(PaddleState& paddle, PaddleInput input, Real deltaTime);
+	uint32_t MoveBall(Real deltaTime);
+	Aabb PaddleBox(const PaddleState& paddle, Real paddleX) const;
+	void HitPaddle(PaddleState& paddle, Vec2 normal);
+	Real PaddleAfter(const PaddleState& paddle, PaddleInput input, Real time) const;
+	//Speed the paddle is moving at right now, zero once it has reached the wall it's heading for
+	Real PaddleVelocity(const PaddleState& paddle, PaddleInput input) const;
+
+	MatchConfig config;
+	MatchState state;
+};
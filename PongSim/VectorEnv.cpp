@@ -0,0 +1,193 @@
+#include "VectorEnv.h"
+
+VectorEnv::VectorEnv(size_t matchCount, const VectorEnvConfig& config, int threadCount) : config(config) {
+	ballX.resize(matchCount);
+	ballY.resize(matchCount);
+	ballVelocityX.resize(matchCount);
+	ballVelocityY.resize(matchCount);
+	leftY.resize(matchCount);
+	rightY.resize(matchCount);
+	leftHits.resize(matchCount);
+	rightHits.resize(matchCount);
+	agentPoints.resize(matchCount);
+	opponentPoints.resize(matchCount);
+	steps.resize(matchCount);
+	rngs.resize(matchCount);
+	opponents.reserve(matchCount);
+	for (size_t i = 0; i < matchCount; i++) {
+		opponents.emplace_back(PaddleSide::Right, config.opponent);
+	}
+
+	observations.resize(matchCount * ObservationSize);
+	rewards.resize(matchCount);
+	dones.resize(matchCount);
+
+	Reset();
+
+	shardCount = threadCount > 1 ? threadCount : 1;
+	for (int shard = 1; shard < shardCount; shard++) {
+		workers.emplace_back(&VectorEnv::WorkerLoop, this, shard);
+	}
+}
+
+VectorEnv::~VectorEnv() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		quitting = true;
+	}
+	wake.notify_all();
+
+	for (std::thread& worker : workers) {
+		worker.join();
+	}
+}
+
+void VectorEnv::Reset() {
+	Match engine(config.match);
+	for (size_t i = 0; i < Size(); i++) {
+		rngs[i].Seed(config.seed, i);
+		opponents[i].Seed(config.seed, OpponentStreams + i);
+		ResetMatch(engine, i);
+		rewards[i] = 0.0f;
+		dones[i] = 0;
+	}
+}
+
+void VectorEnv::Step(const int8_t* actions) {
+	if (workers.empty()) {
+		StepRange(0, Size(), actions);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		currentActions = actions;
+		pending = (int)workers.size();
+		generation++;
+	}
+	wake.notify_all();
+
+	StepRange(0, Size() / shardCount, actions);
+
+	std::unique_lock<std::mutex> lock(mutex);
+	finished.wait(lock, [this] { return pending == 0; });
+}
+
+void VectorEnv::WorkerLoop(int shard) {
+	uint64_t seenGeneration = 0;
+
+	while (true) {
+		const int8_t* actions;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			wake.wait(lock, [&] { return quitting || generation != seenGeneration; });
+			if (quitting) return;
+
+			seenGeneration = generation;
+			actions = currentActions;
+		}
+
+		size_t begin = Size() * shard / shardCount;
+		size_t end = Size() * (shard + 1) / shardCount;
+		StepRange(begin, end, actions);
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			pending--;
+		}
+		finished.notify_one();
+	}
+}
+
+void VectorEnv::StepRange(size_t begin, size_t end, const int8_t* actions) {
+	//One engine per range; each match's state (including its generator) is loaded into it, stepped and written back
+	Match engine(config.match);
+	MatchState state;
+
+	for (size_t i = begin; i < end; i++) {
+		Load(i, state);
+		engine.SetState(state);
+
+		PaddleInput agentInput = (PaddleInput)actions[i];
+		PaddleInput opponentInput = opponents[i].Decide(state, config.match, config.tickLength);
+		uint32_t events = engine.Step(agentInput, opponentInput, config.tickLength);
+
+		float reward = 0.0f;
+		if (events & EventRightGoal) {
+			agentPoints[i]++;
+			reward = 1.0f;
+		}
+		else if (events & EventLeftGoal) {
+			opponentPoints[i]++;
+			reward = -1.0f;
+		}
+		rewards[i] = reward;
+
+		Store(engine.GetState(), i);
+		steps[i]++;
+
+		bool done = agentPoints[i] >= config.pointsToWin || opponentPoints[i] >= config.pointsToWin || steps[i] >= config.maxSteps;
+		dones[i] = done ? 1 : 0;
+
+		if (done) {
+			ResetMatch(engine, i);
+		}
+		else {
+			Observe(i);
+		}
+	}
+}
+
+void VectorEnv::ResetMatch(Match& engine, size_t index) {
+	MatchState state;
+	Load(index, state);
+	engine.SetState(state);
+	engine.Reset();
+	Store(engine.GetState(), index);
+
+	opponents[index].Reset();
+
+	agentPoints[index] = 0;
+	opponentPoints[index] = 0;
+	steps[index] = 0;
+
+	Observe(index);
+}
+
+void VectorEnv::Load(size_t index, MatchState& state) const {
+	state.ball.position = { ballX[index], ballY[index] };
+	state.ball.velocity = { ballVelocityX[index], ballVelocityY[index] };
+	state.left.y = leftY[index];
+	state.left.score = leftHits[index];
+	state.right.y = rightY[index];
+	state.right.score = rightHits[index];
+	state.tick = steps[index];
+	state.rng = rngs[index];
+}
+
+void VectorEnv::Store(const MatchState& state, size_t index) {
+	ballX[index] = state.ball.position.x;
+	ballY[index] = state.ball.position.y;
+	ballVelocityX[index] = state.ball.velocity.x;
+	ballVelocityY[index] = state.ball.velocity.y;
+	leftY[index] = state.left.y;
+	leftHits[index] = state.left.score;
+	rightY[index] = state.right.y;
+	rightHits[index] = state.right.score;
+	rngs[index] = state.rng;
+}
+
+void VectorEnv::Observe(size_t index) {
+	const MatchConfig& match = config.match;
+	float width = ToFloat(match.courtWidth);
+	float height = ToFloat(match.courtHeight);
+	float speed = ToFloat(match.ballSpeed);
+
+	float* observation = &observations[index * ObservationSize];
+	observation[0] = ToFloat(ballX[index]) / width * 2.0f - 1.0f;
+	observation[1] = ToFloat(ballY[index]) / height * 2.0f - 1.0f;
+	observation[2] = ToFloat(ballVelocityX[index]) / speed;
+	observation[3] = ToFloat(ballVelocityY[index]) / speed;
+	observation[4] = ToFloat(leftY[index]) / height * 2.0f - 1.0f;
+	observation[5] = ToFloat(rightY[index]) / height * 2.0f - 1.0f;
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include "Simulation.h"
+#include "AiController.h"
+
+struct VectorEnvConfig {
+	MatchConfig match;
+	Real tickLength = 1.0f / 120.0f;
+
+	//A match ends when either side reaches this many points or after maxSteps ticks
+	int pointsToWin = 5;
+	uint32_t maxSteps = 120 * 60 * 5;
+
+	//Match i draws from stream i of this seed, so every match is independent and reproducible
+	uint64_t seed = 0;
+
+	AiSettings opponent;
+};
+
+//N independent matches advanced together for training. The agent plays the left paddle of every
+//match and an AiController plays the right. State is kept as structure of arrays and results are
+//written to flat arrays; a finished match is reset in place and its observation is of the new match.
+class VectorEnv {
+public:
+	//Ball x, y, ball velocity x, y, agent paddle y, opponent paddle y, scaled to roughly [-1, 1]
+	static const int ObservationSize = 6;
+
+	VectorEnv(size_t matchCount, const VectorEnvConfig& config = VectorEnvConfig(), int threadCount = 1);
+	~VectorEnv();
+
+	VectorEnv(const VectorEnv&) = delete;
+	VectorEnv& operator=(const VectorEnv&) = delete;
+
+	//Reseeds every match from config.seed and starts them over
+	void Reset();
+
+	//One PaddleInput value (-1 up, 0 idle, 1 down) per match
+	void Step(const int8_t* actions);
+
+	size_t Size() const { return ballX.size(); }
+
+	const float* Observations() const { return observations.data(); }
+	const float* Rewards() const { return rewards.data(); }
+	const uint8_t* Dones() const { return dones.data(); }
+
+private:
+	void StepRange(size_t begin, size_t end, const int8_t* actions);
+	void ResetMatch(Match& engine, size_t index);
+	void Load(size_t index, MatchState& state) const;
+	void Store(const MatchState& state, size_t index);
+	void Observe(size_t index);
+	void WorkerLoop(int shard);
+
+	VectorEnvConfig config;
+
+	std::vector<Real> ballX;
+	std::vector<Real> ballY;
+	std::vector<Real> ballVelocityX;
+	std::vector<Real> ballVelocityY;
+	std::vector<Real> leftY;
+	std::vector<Real> rightY;
+	std::vector<int> leftHits;
+	std::vector<int> rightHits;
+	std::vector<int> agentPoints;
+	std::vector<int> opponentPoints;
+	std::vector<uint32_t> steps;
+	std::vector<Rng> rngs;
+	std::vector<AiController> opponents;
+
+	//Opponent i draws from stream OpponentStreams + i of the seed, clear of the match streams
+	static const uint64_t OpponentStreams = 1ULL << 62;
+
+	std::vector<float> observations;
+	std::vector<float> rewards;
+	std::vector<uint8_t> dones;
+
+	//Persistent workers, each owning a fixed shard of the matches. The calling thread runs shard 0.
+	int shardCount;
+	std::vector<std::thread> workers;
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::condition_variable finished;
+	uint64_t generation = 0;
+	int pending = 0;
+	bool quitting = false;
+	const int8_t* currentActions = nullptr;
+};
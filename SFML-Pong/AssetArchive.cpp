@@ -0,0 +1,238 @@
+#include "AssetArchive.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+//Layout, all little endian:
+//  "PONGPAK1", uint32 entry count
+//  per entry: uint32 name length, uint64 offset, uint64 size, name bytes
+//  file contents at their offsets
+static const char Magic[8] = { 'P', 'O', 'N', 'G', 'P', 'A', 'K', '1' };
+static const size_t DataAlignment = 16;
+
+AssetArchive::~AssetArchive() {
+	Close();
+}
+
+//AssetCache hands over paths it has already tidied, so this only has to even out case and separators
+std::string AssetArchive::Key(const std::string& name) {
+	std::string key = name.compare(0, 2, "./") == 0 || name.compare(0, 2, ".\\") == 0 ? name.substr(2) : name;
+	for (char& c : key) {
+		c = c == '\\' ? '/' : (char)std::tolower((unsigned char)c);
+	}
+	return key;
+}
+
+bool AssetArchive::Open(const std::string& path) {
+	Close();
+
+#ifdef _WIN32
+	HANDLE fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (fileHandle == INVALID_HANDLE_VALUE) return false;
+	file = fileHandle;
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0) {
+		Close();
+		return false;
+	}
+
+	mapping = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mapping) {
+		Close();
+		return false;
+	}
+
+	view = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	viewSize = (size_t)fileSize.QuadPart;
+#else
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0) return false;
+
+	struct stat info;
+	if (fstat(fd, &info) != 0 || info.st_size == 0) {
+		close(fd);
+		return false;
+	}
+
+	//The mapping stays valid after the descriptor is closed
+	void* address = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (address == MAP_FAILED) return false;
+
+	view = (const char*)address;
+	viewSize = (size_t)info.st_size;
+#endif
+
+	if (!view || !ReadIndex()) {
+		std::cout << "[ERROR: AssetArchive.cpp]: " << path << " is not a valid asset archive" << std::endl;
+		Close();
+		return false;
+	}
+	return true;
+}
+
+void AssetArchive::Close() {
+	entries.clear();
+
+#ifdef _WIN32
+	if (view) UnmapViewOfFile(view);
+	if (mapping) CloseHandle(mapping);
+	if (file) CloseHandle(file);
+	mapping = nullptr;
+	file = nullptr;
+#else
+	if (view) munmap((void*)view, viewSize);
+#endif
+
+	view = nullptr;
+	viewSize = 0;
+}
+
+bool AssetArchive::ReadIndex() {
+	size_t position = 0;
+	auto read = [&](void* out, size_t bytes) {
+		if (viewSize - position < bytes) return false;
+		memcpy(out, view + position, bytes);
+		position += bytes;
+		return true;
+	};
+
+	char magic[sizeof(Magic)];
+	uint32_t count;
+	if (!read(magic, sizeof(magic)) || memcmp(magic, Magic, sizeof(Magic)) != 0 || !read(&count, sizeof(count)))
+		return false;
+
+	for (uint32_t i = 0; i < count; i++) {
+		uint32_t nameLength;
+		uint64_t offset;
+		uint64_t size;
+		if (!read(&nameLength, sizeof(nameLength)) || !read(&offset, sizeof(offset)) || !read(&size, sizeof(size)))
+			return false;
+		if (viewSize - position < nameLength || offset > viewSize || size > viewSize - offset)
+			return false;
+
+		std::string name(view + position, nameLength);
+		position += nameLength;
+
+		entries[Key(name)] = { view + offset, (size_t)size };
+	}
+	return true;
+}
+
+const void* AssetArchive::Find(const std::string& name, size_t& size) const {
+	auto entry = entries.find(Key(name));
+	if (entry == entries.end()) return nullptr;
+
+	size = entry->second.size;
+	return entry->second.data;
+}
+
+static void ListFiles(const std::string& directory, std::vector<std::string>& files) {
+#ifdef _WIN32
+	WIN32_FIND_DATAA found;
+	HANDLE search = FindFirstFileA((directory + "/*").c_str(), &found);
+	if (search == INVALID_HANDLE_VALUE) return;
+
+	do {
+		std::string name = found.cFileName;
+		if (name == "." || name == "..") continue;
+
+		if (found.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) ListFiles(directory + "/" + name, files);
+		else files.push_back(directory + "/" + name);
+	} while (FindNextFileA(search, &found));
+	FindClose(search);
+#else
+	DIR* dir = opendir(directory.c_str());
+	if (!dir) return;
+
+	while (dirent* entry = readdir(dir)) {
+		std::string name = entry->d_name;
+		if (name == "." || name == "..") continue;
+
+		std::string path = directory + "/" + name;
+		struct stat info;
+		if (stat(path.c_str(), &info) != 0) continue;
+
+		if (S_ISDIR(info.st_mode)) ListFiles(path, files);
+		else if (S_ISREG(info.st_mode)) files.push_back(path);
+	}
+	closedir(dir);
+#endif
+}
+
+bool AssetArchive::Pack(const std::string& directory, const std::string& outputPath) {
+	std::vector<std::string> files;
+	ListFiles(directory, files);
+
+	//Sorted so the same assets always produce the same archive
+	std::sort(files.begin(), files.end());
+
+	std::vector<std::vector<char>> contents(files.size());
+	for (size_t i = 0; i < files.size(); i++) {
+		std::ifstream input(files[i], std::ios::binary);
+		if (!input) {
+			std::cout << "[ERROR: AssetArchive.cpp]: Could not read " << files[i] << std::endl;
+			return false;
+		}
+		contents[i].assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+	}
+
+	size_t indexSize = sizeof(Magic) + sizeof(uint32_t);
+	for (const std::string& file : files) {
+		indexSize += sizeof(uint32_t) + sizeof(uint64_t) * 2 + file.size();
+	}
+
+	std::vector<char> archive;
+	auto write = [&](const void* data, size_t bytes) {
+		archive.insert(archive.end(), (const char*)data, (const char*)data + bytes);
+	};
+
+	write(Magic, sizeof(Magic));
+	uint32_t count = (uint32_t)files.size();
+	write(&count, sizeof(count));
+
+	uint64_t offset = indexSize;
+	for (size_t i = 0; i < files.size(); i++) {
+		offset = (offset + DataAlignment - 1) / DataAlignment * DataAlignment;
+
+		uint32_t nameLength = (uint32_t)files[i].size();
+		uint64_t size = contents[i].size();
+		write(&nameLength, sizeof(nameLength));
+		write(&offset, sizeof(offset));
+		write(&size, sizeof(size));
+		write(files[i].data(), files[i].size());
+
+		offset += size;
+	}
+
+	for (const std::vector<char>& content : contents) {
+		archive.resize((archive.size() + DataAlignment - 1) / DataAlignment * DataAlignment, 0);
+		write(content.data(), content.size());
+	}
+
+	std::ofstream output(outputPath, std::ios::binary);
+	output.write(archive.data(), archive.size());
+	if (!output) {
+		std::cout << "[ERROR: AssetArchive.cpp]: Could not write " << outputPath << std::endl;
+		return false;
+	}
+
+	std::cout << "Packed " << files.size() << " assets (" << archive.size() << " bytes) into " << outputPath << std::endl;
+	return true;
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+//Every asset in one file: a small index followed by the file contents, each 16 byte aligned.
+//Opening maps the whole archive into memory, and Find returns pointers straight into the
+//mapping, so loading from it copies nothing until SFML decodes the data.
+class AssetArchive {
+public:
+	AssetArchive() = default;
+	~AssetArchive();
+
+	AssetArchive(const AssetArchive&) = delete;
+	AssetArchive& operator=(const AssetArchive&) = delete;
+
+	bool Open(const std::string& path);
+	void Close();
+	bool IsOpen() const { return view != nullptr; }
+
+	//Names are paths like "Assets/Sounds/wallHit.wav", matched ignoring case and separator style.
+	//Returns nullptr when the archive has no such file.
+	const void* Find(const std::string& name, size_t& size) const;
+
+	size_t GetEntryCount() const { return entries.size(); }
+
+	//Writes every file under directory (recursively) to outputPath. Entries are named by their
+	//path from the current directory, the same way the game asks for them.
+	static bool Pack(const std::string& directory, const std::string& outputPath);
+
+private:
+	struct Entry {
+		const char* data;
+		size_t size;
+	};
+
+	static std::string Key(const std::string& name);
+	bool ReadIndex();
+
+	std::unordered_map<std::string, Entry> entries;
+
+	const char* view = nullptr;
+	size_t viewSize = 0;
+#ifdef _WIN32
+	void* file = nullptr;
+	void* mapping = nullptr;
+#endif
+};
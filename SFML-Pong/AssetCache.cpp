@@ -0,0 +1,244 @@
+#include "AssetCache.h"
+#include "EmbeddedAssets.h"
+#include <cctype>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+#ifndef _WIN32
+#include <dirent.h>
+#include <strings.h>
+#include <sys/stat.h>
+#endif
+
+static bool ReadFile(const std::string& path, std::vector<char>& data) {
+	std::ifstream file(path, std::ios::binary);
+	if (!file) return false;
+
+	data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	return true;
+}
+
+#ifndef _WIN32
+static bool Exists(const std::string& path) {
+	struct stat info;
+	return stat(path.c_str(), &info) == 0;
+}
+
+//Name of the entry in directory that matches name ignoring case, or an empty string
+static std::string FindIgnoringCase(const std::string& directory, const std::string& name) {
+	std::string match;
+
+	DIR* dir = opendir(directory.empty() ? "." : directory.c_str());
+	if (!dir) return match;
+
+	while (dirent* entry = readdir(dir)) {
+		if (strcasecmp(entry->d_name, name.c_str()) == 0) {
+			match = entry->d_name;
+			break;
+		}
+	}
+
+	closedir(dir);
+	return match;
+}
+#endif
+
+//Splits path into its segments with "." dropped and ".." applied
+static std::vector<std::string> SplitPath(const std::string& path, bool absolute) {
+	std::vector<std::string> segments;
+	std::string segment;
+	for (size_t i = 0; i <= path.size(); i++) {
+		char c = i < path.size() ? path[i] : '/';
+		if (c != '/' && c != '\\') {
+			segment += c;
+			continue;
+		}
+
+		if (segment == "..") {
+			if (!segments.empty() && segments.back() != "..")
+				segments.pop_back();
+			else if (!absolute)
+				segments.push_back(segment);
+		}
+		else if (!segment.empty() && segment != ".") {
+			segments.push_back(segment);
+		}
+		segment.clear();
+	}
+	return segments;
+}
+
+static bool IsAbsolute(const std::string& path) {
+	return !path.empty() && (path[0] == '/' || path[0] == '\\');
+}
+
+std::string AssetCache::NormalisePath(const std::string& path) {
+	bool absolute = IsAbsolute(path);
+	std::vector<std::string> segments = SplitPath(path, absolute);
+
+	std::string normalised = absolute ? "/" : "";
+	for (size_t i = 0; i < segments.size(); i++) {
+		normalised += (i > 0 ? "/" : "") + segments[i];
+	}
+	return normalised;
+}
+
+std::string AssetCache::ResolvePath(const std::string& path) {
+	bool absolute = IsAbsolute(path);
+	std::vector<std::string> segments = SplitPath(path, absolute);
+
+	std::string resolved = absolute ? "/" : "";
+	for (size_t i = 0; i < segments.size(); i++) {
+		std::string next = resolved + (i > 0 ? "/" : "") + segments[i];
+
+#ifndef _WIN32
+		if (!Exists(next)) {
+			std::string match = FindIgnoringCase(resolved, segments[i]);
+			if (!match.empty()) {
+				next = resolved + (i > 0 ? "/" : "") + match;
+			}
+		}
+#endif
+
+		resolved = next;
+	}
+
+	return resolved;
+}
+
+const void* AssetCache::FindPacked(const std::string& path, const std::shared_ptr<const AssetArchive>& archive, size_t& size, std::string& key) {
+	//Packed names ignore case, so the tidied name is enough to find them without touching the disk
+	key = NormalisePath(path);
+
+	const void* packed = nullptr;
+	if (const EmbeddedAsset* embedded = FindEmbeddedAsset(key)) {
+		size = embedded->size;
+		packed = embedded->data;
+	}
+	else if (archive) {
+		packed = archive->Find(key, size);
+	}
+
+	if (packed) {
+		for (char& c : key) {
+			c = (char)std::tolower((unsigned char)c);
+		}
+	}
+	else {
+		key = ResolvePath(key);
+	}
+	return packed;
+}
+
+void AssetCache::Mount(std::shared_ptr<const AssetArchive> mounted) {
+	std::lock_guard<std::mutex> lock(mutex);
+	archive = mounted;
+}
+
+std::shared_ptr<const AssetArchive> AssetCache::GetArchive() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return archive;
+}
+
+std::shared_ptr<const sf::Font> AssetCache::GetFont(const std::string& path) {
+	std::shared_ptr<const AssetArchive> source = GetArchive();
+
+	size_t size = 0;
+	std::string key;
+	const void* packed = FindPacked(path, source, size, key);
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (std::shared_ptr<FontAsset> cached = fonts[key].lock()) {
+			return std::shared_ptr<const sf::Font>(cached, &cached->font);
+		}
+	}
+
+	//Load outside the lock so other assets can load at the same time
+	std::shared_ptr<FontAsset> asset = std::make_shared<FontAsset>();
+
+	bool loaded;
+	if (packed) {
+		asset->archive = source;
+		asset->size = size;
+		loaded = asset->font.loadFromMemory(packed, size);
+	}
+	else {
+		loaded = ReadFile(key, asset->data) && asset->font.loadFromMemory(asset->data.data(), asset->data.size());
+		asset->size = asset->data.size();
+	}
+
+	if (!loaded) {
+		std::cout << "[ERROR: AssetCache.cpp]: Font at " << path << " could not be found" << std::endl;
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+	if (std::shared_ptr<FontAsset> cached = fonts[key].lock()) {
+		asset = cached;
+	}
+	else {
+		fonts[key] = asset;
+	}
+	return std::shared_ptr<const sf::Font>(asset, &asset->font);
+}
+
+std::shared_ptr<const sf::SoundBuffer> AssetCache::GetSoundBuffer(const std::string& path) {
+	std::shared_ptr<const AssetArchive> source = GetArchive();
+
+	size_t size = 0;
+	std::string key;
+	const void* packed = FindPacked(path, source, size, key);
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (std::shared_ptr<SoundAsset> cached = sounds[key].lock()) {
+			return std::shared_ptr<const sf::SoundBuffer>(cached, &cached->buffer);
+		}
+	}
+
+	//The buffer decodes into its own samples, so the archive isn't needed afterwards
+	std::shared_ptr<SoundAsset> asset = std::make_shared<SoundAsset>();
+
+	bool loaded = packed ? asset->buffer.loadFromMemory(packed, size) : asset->buffer.loadFromFile(key);
+	if (!loaded) {
+		std::cout << "[ERROR: AssetCache.cpp]: Sound buffer at " << path << " could not be found" << std::endl;
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+	if (std::shared_ptr<SoundAsset> cached = sounds[key].lock()) {
+		asset = cached;
+	}
+	else {
+		sounds[key] = asset;
+	}
+	return std::shared_ptr<const sf::SoundBuffer>(asset, &asset->buffer);
+}
+
+std::vector<AssetCache::AssetInfo> AssetCache::Report() const {
+	std::vector<AssetInfo> report;
+
+	std::lock_guard<std::mutex> lock(mutex);
+	for (const auto& entry : fonts) {
+		if (std::shared_ptr<FontAsset> asset = entry.second.lock()) {
+			//Glyph pages are created per character size on demand and aren't counted
+			report.push_back({ entry.first, "font", asset->size, asset.use_count() - 1 });
+		}
+	}
+	for (const auto& entry : sounds) {
+		if (std::shared_ptr<SoundAsset> asset = entry.second.lock()) {
+			size_t bytes = (size_t)asset->buffer.getSampleCount() * sizeof(sf::Int16);
+			report.push_back({ entry.first, "sound", bytes, asset.use_count() - 1 });
+		}
+	}
+	return report;
+}
+
+void AssetCache::PrintReport(std::ostream& out) const {
+	size_t total = 0;
+	for (const AssetInfo& info : Report()) {
+		out << info.kind << " " << info.path << ": " << info.bytes << " bytes, " << info.handles << " handles" << std::endl;
+		total += info.bytes;
+	}
+	out << "Total: " << total << " bytes" << std::endl;
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include "AssetArchive.h"
+#include <SFML/Graphics/Font.hpp>
+#include <SFML/Audio/SoundBuffer.hpp>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <ostream>
+#include <cstddef>
+
+//Loads each font and sound buffer once and hands out shared handles to it. Assets are keyed by
+//their resolved path, so "a/./b.wav", "a\\b.wav" and (where the file system is case sensitive)
+//"a/B.WAV" all share one copy. An asset is freed when its last handle goes away.
+//Assets compiled into the executable come first, then a mounted archive, then loose files. The
+//first two are found by name alone, so only loose files cost any file system calls.
+class AssetCache {
+public:
+	struct AssetInfo {
+		std::string path;
+		const char* kind;
+		size_t bytes;
+		long handles;
+	};
+
+	//Assets already loaded keep using whatever they were loaded from
+	void Mount(std::shared_ptr<const AssetArchive> archive);
+
+	std::shared_ptr<const sf::Font> GetFont(const std::string& path);
+	std::shared_ptr<const sf::SoundBuffer> GetSoundBuffer(const std::string& path);
+
+	//Assets that are still loaded, with an estimate of the memory each one holds
+	std::vector<AssetInfo> Report() const;
+	void PrintReport(std::ostream& out) const;
+
+	//Tidies separators and "." / ".." segments without looking at the file system
+	static std::string NormalisePath(const std::string& path);
+
+	//NormalisePath, then matches each segment case-insensitively against the directory contents
+	//if the path doesn't exist as written
+	static std::string ResolvePath(const std::string& path);
+
+private:
+	//The font keeps reading glyphs from its file data, so that data (or the archive it's
+	//mapped from) lives alongside it
+	struct FontAsset {
+		std::vector<char> data;
+		std::shared_ptr<const AssetArchive> archive;
+		size_t size = 0;
+		sf::Font font;
+	};
+
+	//Data compiled in or in the archive, else nullptr. Sets key to the name the asset is cached
+	//under: the lowercased tidy name when packed, else the resolved path of the loose file.
+	static const void* FindPacked(const std::string& path, const std::shared_ptr<const AssetArchive>& archive, size_t& size, std::string& key);
+
+	std::shared_ptr<const AssetArchive> GetArchive() const;
+
+	struct SoundAsset {
+		sf::SoundBuffer buffer;
+	};
+
+	mutable std::mutex mutex;
+	std::shared_ptr<const AssetArchive> archive;
+	std::map<std::string, std::weak_ptr<FontAsset>> fonts;
+	std::map<std::string, std::weak_ptr<SoundAsset>> sounds;
+};
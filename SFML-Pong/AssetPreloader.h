@@ -0,0 +1,78 @@
+#pragma once
+#include "AssetCache.h"
+#include <chrono>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+//Starts loading assets into an AssetCache on background threads, so decoding overlaps with
+//window and GL context creation. Each call starts one job, which may load several assets, and
+//counts as one step of progress. The loaded assets are held until Release, since the cache only
+//keeps assets that something still has a handle to.
+class AssetPreloader {
+public:
+	AssetPreloader(AssetCache& assets) : assets(assets) {}
+
+	~AssetPreloader() {
+		Release();
+	}
+
+	void Font(const std::string& path) {
+		AssetCache* cache = &assets;
+		jobs.push_back(std::async(std::launch::async, [cache, path]() -> std::shared_ptr<const void> {
+			return cache->GetFont(path);
+		}));
+	}
+
+	//SFML 2.5 registers its sound file readers on first use without a lock, so two sounds must
+	//never decode at the same time. These load one after another on a single thread.
+	void SoundBuffers(const std::vector<std::string>& paths) {
+		AssetCache* cache = &assets;
+		jobs.push_back(std::async(std::launch::async, [cache, paths]() -> std::shared_ptr<const void> {
+			auto buffers = std::make_shared<std::vector<std::shared_ptr<const sf::SoundBuffer>>>();
+			for (const std::string& path : paths) {
+				buffers->push_back(cache->GetSoundBuffer(path));
+			}
+			return buffers;
+		}));
+	}
+
+	size_t GetCount() const { return jobs.size() + loaded.size(); }
+
+	//Collects whatever has finished and returns how much that is
+	size_t Poll() {
+		for (size_t i = 0; i < jobs.size();) {
+			if (jobs[i].wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+				loaded.push_back(jobs[i].get());
+				jobs.erase(jobs.begin() + i);
+			}
+			else {
+				i++;
+			}
+		}
+		return loaded.size();
+	}
+
+	bool IsDone() {
+		return Poll() == GetCount();
+	}
+
+	void Wait() {
+		for (std::future<std::shared_ptr<const void>>& job : jobs) {
+			loaded.push_back(job.get());
+		}
+		jobs.clear();
+	}
+
+	//Call once everything that needs the assets has its own handle
+	void Release() {
+		Wait();
+		loaded.clear();
+	}
+
+private:
+	AssetCache& assets;
+	std::vector<std::future<std::shared_ptr<const void>>> jobs;
+	std::vector<std::shared_ptr<const void>> loaded;
+};
@@ -0,0 +1,68 @@
+#pragma once
+#include "VoicePool.h"
+#include "SoundSynth.h"
+#include <string>
+#include <vector>
+#include <cstddef>
+
+//What SoundEffect plays through. Sounds are loaded by the backend and referred to by id, so a
+//backend without a device never has to create an sf::SoundBuffer (which opens one).
+class AudioBackend {
+public:
+	virtual ~AudioBackend() = default;
+
+	//Returns the id to play the sound with. Loading the same path twice may return either id.
+	virtual int LoadSound(const std::string& path) = 0;
+	//Synthesises the sound instead of reading a file
+	virtual int LoadTone(const ToneSettings& tone) = 0;
+
+	virtual void Play(int sound, const VoicePool::PlayParams& params) = 0;
+	virtual void Pause(int sound) = 0;
+	virtual void Stop(int sound) = 0;
+	virtual void StopAll() = 0;
+	virtual void SetVolume(int sound, float volume) = 0;
+};
+
+//Plays nothing and loads nothing, for headless runs and machines without a sound card
+class NullAudio : public AudioBackend {
+public:
+	int LoadSound(const std::string&) override { return 0; }
+	int LoadTone(const ToneSettings&) override { return 0; }
+
+	void Play(int, const VoicePool::PlayParams&) override {}
+	void Pause(int) override {}
+	void Stop(int) override {}
+	void StopAll() override {}
+	void SetVolume(int, float) override {}
+};
+
+//Plays nothing but remembers what was asked for, so tests can check which sounds a run made
+class CountingAudio : public AudioBackend {
+public:
+	int LoadSound(const std::string& path) override {
+		paths.push_back(path);
+		plays.push_back(0);
+		return (int)paths.size() - 1;
+	}
+	int LoadTone(const ToneSettings& tone) override {
+		return LoadSound("tone:" + std::to_string((int)tone.frequency) + "Hz");
+	}
+
+	void Play(int sound, const VoicePool::PlayParams&) override {
+		plays[sound]++;
+		totalPlays++;
+	}
+	void Pause(int) override {}
+	void Stop(int) override {}
+	void StopAll() override {}
+	void SetVolume(int, float) override {}
+
+	const std::string& GetPath(int sound) const { return paths[sound]; }
+	size_t GetPlayCount(int sound) const { return plays[sound]; }
+	size_t GetTotalPlays() const { return totalPlays; }
+
+private:
+	std::vector<std::string> paths;
+	std::vector<size_t> plays;
+	size_t totalPlays = 0;
+};
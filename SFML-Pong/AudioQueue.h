@@ -0,0 +1,72 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+
+//Collects sound requests from the simulation during a frame and hands them to the audio system
+//once, after all the ticks have run. Requests for the same sound within a frame collapse into
+//one, and a sound that played less than its minimum interval ago is skipped, so a frame with
+//hundreds of collisions still makes at most one play call per sound.
+class AudioQueue {
+public:
+	struct Stats {
+		size_t pushed = 0;
+		size_t played = 0;
+		size_t coalesced = 0;
+		size_t rateLimited = 0;
+	};
+
+	//Returns the id to push for this sound
+	int AddSound(float minInterval) {
+		Sound sound;
+		sound.minInterval = minInterval;
+		sounds.push_back(sound);
+		return (int)sounds.size() - 1;
+	}
+
+	//Cheap enough to call from inside the tick loop: it only bumps a counter. When requests
+	//are merged the highest pitch wins, so the fastest ball is the one heard.
+	void Push(int sound, size_t count = 1, float pitch = 1.0f) {
+		if (count == 0) return;
+		Sound& entry = sounds[sound];
+		if (entry.pending == 0 || pitch > entry.pitch) entry.pitch = pitch;
+		entry.pending += count;
+		stats.pushed += count;
+	}
+
+	//Calls play(sound, count, pitch) once for each sound pushed since the last flush that is allowed
+	//to play at time now (in seconds), where count is how many requests were merged into it
+	template<typename PlayFunction>
+	void Flush(float now, PlayFunction play) {
+		for (int i = 0; i < (int)sounds.size(); i++) {
+			Sound& sound = sounds[i];
+			if (sound.pending == 0) continue;
+
+			if (sound.hasPlayed && now - sound.lastPlayed < sound.minInterval) {
+				stats.rateLimited += sound.pending;
+			}
+			else {
+				play(i, sound.pending, sound.pitch);
+				stats.played++;
+				stats.coalesced += sound.pending - 1;
+				sound.lastPlayed = now;
+				sound.hasPlayed = true;
+			}
+			sound.pending = 0;
+		}
+	}
+
+	const Stats& GetStats() const { return stats; }
+	void ResetStats() { stats = Stats(); }
+
+private:
+	struct Sound {
+		float minInterval = 0.0f;
+		float lastPlayed = 0.0f;
+		bool hasPlayed = false;
+		size_t pending = 0;
+		float pitch = 1.0f;
+	};
+
+	std::vector<Sound> sounds;
+	Stats stats;
+};
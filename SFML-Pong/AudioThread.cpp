@@ -0,0 +1,51 @@
+#include "AudioThread.h"
+#include "VoicePool.h"
+#include <SFML/System/Sleep.hpp>
+
+AudioThread::AudioThread(AssetCache& assets, size_t voiceCount) : QueuedAudio(assets), voiceCount(voiceCount), running(true) {
+	thread = std::thread(&AudioThread::Run, this);
+}
+
+AudioThread::~AudioThread() {
+	StopAll();
+	running.store(false, std::memory_order_release);
+	thread.join();
+}
+
+void AudioThread::Run() {
+	//Voices are created here so their OpenAL sources belong to this thread from the start
+	VoicePool voices(voiceCount);
+
+	Command command;
+	while (true) {
+		bool stopping = !running.load(std::memory_order_acquire);
+
+		bool worked = false;
+		while (PopCommand(command)) {
+			switch (command.type) {
+			case CommandType::Play:
+				voices.Play(*command.buffer, command.params);
+				break;
+			case CommandType::Pause:
+				voices.Pause(*command.buffer);
+				break;
+			case CommandType::Stop:
+				voices.Stop(*command.buffer);
+				break;
+			case CommandType::StopAll:
+				voices.StopAll();
+				break;
+			case CommandType::SetVolume:
+				voices.SetVolume(*command.buffer, command.params.volume);
+				break;
+			}
+			command = Command();
+			worked = true;
+		}
+
+		if (stopping) break;
+
+		//sf::sleep raises the timer resolution on Windows, so this really is about a millisecond
+		if (!worked) sf::sleep(sf::milliseconds(1));
+	}
+}
@@ -0,0 +1,24 @@
+#pragma once
+#include "QueuedAudio.h"
+#include "AssetCache.h"
+#include <atomic>
+#include <thread>
+#include <cstddef>
+
+//The OpenAL backend. All OpenAL work, VoicePool included, runs on its own thread, so a play or
+//stop call never waits on the audio device or the OpenAL context lock.
+class AudioThread : public QueuedAudio {
+public:
+	AudioThread(AssetCache& assets, size_t voiceCount = 16);
+	~AudioThread();
+
+	AudioThread(const AudioThread&) = delete;
+	AudioThread& operator=(const AudioThread&) = delete;
+
+private:
+	void Run();
+
+	size_t voiceCount;
+	std::atomic<bool> running;
+	std::thread thread;
+};
@@ -0,0 +1,85 @@
+#include "CourtRenderer.h"
+#include <cmath>
+
+CourtRenderer::CourtRenderer(unsigned circleResolution) : vertices(sf::Triangles) {
+	//White disc with a soft one pixel edge
+	sf::Image image;
+	image.create(circleResolution, circleResolution, sf::Color::Transparent);
+
+	float centre = circleResolution / 2.0f;
+	for (unsigned y = 0; y < circleResolution; y++) {
+		for (unsigned x = 0; x < circleResolution; x++) {
+			float dx = x + 0.5f - centre;
+			float dy = y + 0.5f - centre;
+			float coverage = centre - std::sqrt(dx * dx + dy * dy) + 0.5f;
+			coverage = coverage < 0.0f ? 0.0f : (coverage > 1.0f ? 1.0f : coverage);
+
+			image.setPixel(x, y, sf::Color(255, 255, 255, (sf::Uint8)(coverage * 255.0f)));
+		}
+	}
+
+	circleTexture.loadFromImage(image);
+	circleTexture.setSmooth(true);
+
+	float size = (float)circleResolution;
+	circleCoords = sf::FloatRect(0.0f, 0.0f, size, size);
+	solidCoords = sf::FloatRect(centre - 2.0f, centre - 2.0f, 4.0f, 4.0f);
+}
+
+void CourtRenderer::Begin() {
+	//Keeps the vertex storage from the previous frame
+	vertices.clear();
+	transform = sf::Transform::Identity;
+}
+
+void CourtRenderer::AddQuad(float x, float y, float width, float height, sf::Color color, const sf::FloatRect& texture) {
+	sf::Vector2f topLeft = transform.transformPoint(x, y);
+	sf::Vector2f topRight = transform.transformPoint(x + width, y);
+	sf::Vector2f bottomRight = transform.transformPoint(x + width, y + height);
+	sf::Vector2f bottomLeft = transform.transformPoint(x, y + height);
+
+	float u0 = texture.left;
+	float v0 = texture.top;
+	float u1 = texture.left + texture.width;
+	float v1 = texture.top + texture.height;
+
+	vertices.append(sf::Vertex(topLeft, color, sf::Vector2f(u0, v0)));
+	vertices.append(sf::Vertex(topRight, color, sf::Vector2f(u1, v0)));
+	vertices.append(sf::Vertex(bottomRight, color, sf::Vector2f(u1, v1)));
+
+	vertices.append(sf::Vertex(topLeft, color, sf::Vector2f(u0, v0)));
+	vertices.append(sf::Vertex(bottomRight, color, sf::Vector2f(u1, v1)));
+	vertices.append(sf::Vertex(bottomLeft, color, sf::Vector2f(u0, v1)));
+}
+
+void CourtRenderer::AddRect(float x, float y, float width, float height, sf::Color color) {
+	AddQuad(x, y, width, height, color, solidCoords);
+}
+
+void CourtRenderer::AddBall(float x, float y, float size, sf::Color color) {
+	AddQuad(x, y, size, size, color, circleCoords);
+}
+
+void CourtRenderer::AddBalls(const float* x, const float* y, size_t count, float size, sf::Color color) {
+	for (size_t i = 0; i < count; i++) {
+		AddQuad(x[i], y[i], size, size, color, circleCoords);
+	}
+}
+
+void CourtRenderer::AddCourtMarkings(float courtWidth, float courtHeight, sf::Color color) {
+	const float dashWidth = 4.0f;
+	const float dashHeight = 20.0f;
+
+	float x = (courtWidth - dashWidth) / 2;
+	for (float y = dashHeight / 2; y < courtHeight; y += dashHeight * 2) {
+		AddRect(x, y, dashWidth, dashHeight, color);
+	}
+}
+
+void CourtRenderer::Draw(sf::RenderTarget& target) {
+	if (vertices.getVertexCount() == 0) return;
+
+	sf::RenderStates states;
+	states.texture = &circleTexture;
+	target.draw(vertices, states);
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+
+//Collects everything on the court (paddles, balls, markings) into one vertex stream and draws it
+//with a single call. All quads share one texture: a white disc for balls, whose opaque middle
+//texel doubles as the fill for rectangles. Positions can be transformed as they are added so
+//several matches can be laid out side by side in one batch.
+class CourtRenderer {
+public:
+	CourtRenderer(unsigned circleResolution = 64);
+
+	void Begin();
+
+	void SetTransform(const sf::Transform& newTransform) { transform = newTransform; }
+
+	void AddRect(float x, float y, float width, float height, sf::Color color);
+	void AddBall(float x, float y, float size, sf::Color color);
+	void AddBalls(const float* x, const float* y, size_t count, float size, sf::Color color);
+
+	//Dashed centre line
+	void AddCourtMarkings(float courtWidth, float courtHeight, sf::Color color);
+
+	void Draw(sf::RenderTarget& target);
+
+	size_t GetQuadCount() const { return vertices.getVertexCount() / 6; }
+
+private:
+	void AddQuad(float x, float y, float width, float height, sf::Color color, const sf::FloatRect& texture);
+
+	sf::Texture circleTexture;
+	sf::FloatRect circleCoords;
+	sf::FloatRect solidCoords;
+
+	sf::Transform transform;
+	sf::VertexArray vertices;
+};
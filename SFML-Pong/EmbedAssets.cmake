@@ -0,0 +1,44 @@
+# Turns every file under ASSET_ROOT/Assets into a constexpr byte array for EmbeddedAssets.cpp.
+# Run as a pre-build step when embedding is enabled:
+#   cmake -DASSET_ROOT=<project dir> -DOUTPUT=<project dir>/EmbeddedAssetData.h -P EmbedAssets.cmake
+# The output is only rewritten when it changes, so unchanged assets don't trigger a rebuild.
+
+if(NOT ASSET_ROOT OR NOT OUTPUT)
+	message(FATAL_ERROR "EmbedAssets.cmake needs ASSET_ROOT and OUTPUT")
+endif()
+
+file(GLOB_RECURSE files RELATIVE "${ASSET_ROOT}" "${ASSET_ROOT}/Assets/*")
+list(SORT files)
+
+set(arrays "")
+set(table "")
+set(index 0)
+foreach(file IN LISTS files)
+	file(SIZE "${ASSET_ROOT}/${file}" size)
+	if(size GREATER 0)
+		file(READ "${ASSET_ROOT}/${file}" hex HEX)
+		string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," bytes "${hex}")
+		# Sixteen bytes (five characters each) to a line
+		string(REPEAT "....." 16 line)
+		string(REGEX REPLACE "(${line})" "\\1\n\t" bytes "${bytes}")
+
+		string(APPEND arrays "//${file}\nalignas(16) static constexpr unsigned char EmbeddedAsset${index}[] = {\n\t${bytes}\n};\n\n")
+		string(APPEND table "\t{ \"${file}\", EmbeddedAsset${index}, sizeof(EmbeddedAsset${index}) },\n")
+		math(EXPR index "${index} + 1")
+	endif()
+endforeach()
+
+if(index EQUAL 0)
+	message(FATAL_ERROR "EmbedAssets.cmake found no assets under ${ASSET_ROOT}/Assets")
+endif()
+
+set(content "//Generated by EmbedAssets.cmake from the Assets folder. Do not edit.\n#pragma once\n\n${arrays}static const EmbeddedAsset EmbeddedAssetList[] = {\n${table}};\n")
+
+set(existing "")
+if(EXISTS "${OUTPUT}")
+	file(READ "${OUTPUT}" existing)
+endif()
+if(NOT existing STREQUAL content)
+	file(WRITE "${OUTPUT}" "${content}")
+	message(STATUS "Embedded ${index} assets into ${OUTPUT}")
+endif()
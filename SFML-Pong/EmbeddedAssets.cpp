@@ -0,0 +1,35 @@
+#include "EmbeddedAssets.h"
+#include <cctype>
+
+#ifdef PONG_EMBED_ASSETS
+#include "EmbeddedAssetData.h"
+static const size_t EmbeddedAssetCount = sizeof(EmbeddedAssetList) / sizeof(EmbeddedAssetList[0]);
+#else
+static const EmbeddedAsset* const EmbeddedAssetList = nullptr;
+static const size_t EmbeddedAssetCount = 0;
+#endif
+
+static bool SameName(const char* embedded, const std::string& name) {
+	size_t start = name.compare(0, 2, "./") == 0 || name.compare(0, 2, ".\\") == 0 ? 2 : 0;
+
+	size_t i = 0;
+	for (; embedded[i] != '\0'; i++) {
+		if (start + i >= name.size()) return false;
+
+		char a = embedded[i] == '\\' ? '/' : (char)std::tolower((unsigned char)embedded[i]);
+		char b = name[start + i] == '\\' ? '/' : (char)std::tolower((unsigned char)name[start + i]);
+		if (a != b) return false;
+	}
+	return start + i == name.size();
+}
+
+const EmbeddedAsset* FindEmbeddedAsset(const std::string& name) {
+	for (size_t i = 0; i < EmbeddedAssetCount; i++) {
+		if (SameName(EmbeddedAssetList[i].name, name)) return &EmbeddedAssetList[i];
+	}
+	return nullptr;
+}
+
+size_t GetEmbeddedAssetCount() {
+	return EmbeddedAssetCount;
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include <string>
+#include <cstddef>
+
+//Assets compiled into the executable. Building with PONG_EMBED_ASSETS runs EmbedAssets.cmake
+//before compiling, which turns everything under Assets into byte arrays. Without it there are
+//none and every lookup misses.
+struct EmbeddedAsset {
+	const char* name;
+	const unsigned char* data;
+	size_t size;
+};
+
+//Names are paths like "Assets/Sounds/wallHit.wav", matched ignoring case and separator style.
+//Returns nullptr when the file wasn't embedded.
+const EmbeddedAsset* FindEmbeddedAsset(const std::string& name);
+
+size_t GetEmbeddedAssetCount();
@@ -0,0 +1,50 @@
+#pragma once
+
+//Turns variable frame times into a whole number of fixed simulation ticks. Leftover time is
+//carried to the next frame and exposed as an interpolation factor for rendering.
+class FixedTimestep {
+public:
+	FixedTimestep(float tickRate = 120.0f, int maxTicksPerFrame = 8) {
+		SetTickRate(tickRate);
+		SetMaxTicksPerFrame(maxTicksPerFrame);
+	}
+
+	void SetTickRate(float tickRate) {
+		tickLength = 1.0f / tickRate;
+		accumulator = 0.0f;
+	}
+
+	void SetMaxTicksPerFrame(int maxTicks) {
+		maxTicksPerFrame = maxTicks > 0 ? maxTicks : 1;
+	}
+
+	//Returns how many ticks to run for this frame. A long frame (window drag, debugger) is
+	//clamped to maxTicksPerFrame and the rest of the time is dropped rather than simulated.
+	int Advance(float frameTime) {
+		accumulator += frameTime;
+
+		float maxAccumulated = tickLength * maxTicksPerFrame;
+		if (accumulator > maxAccumulated) {
+			accumulator = maxAccumulated;
+		}
+
+		int ticks = 0;
+		while (accumulator >= tickLength) {
+			accumulator -= tickLength;
+			ticks++;
+		}
+		return ticks;
+	}
+
+	float GetTickLength() const { return tickLength; }
+
+	//How far between the previous and the current tick the frame is being shown, in [0, 1)
+	float GetAlpha() const { return accumulator / tickLength; }
+
+	float GetAccumulator() const { return accumulator; }
+
+private:
+	float tickLength;
+	float accumulator = 0.0f;
+	int maxTicksPerFrame;
+};
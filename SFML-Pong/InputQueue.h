@@ -0,0 +1,38 @@
+#pragma once
+#include "InputState.h"
+#include <SFML/Window/Event.hpp>
+#include <deque>
+#include <cstdint>
+#include <cstddef>
+
+//Window events stamped with the time they were taken off the OS queue. The fixed tick loop
+//feeds each one to the InputState at the tick that covers its time, so a press partway through
+//a frame moves the paddle from that tick rather than from the start of the next frame.
+class InputQueue {
+public:
+	//time is in microseconds on the same clock the tick loop uses. Only the events InputState
+	//reacts to are kept, so mouse motion and the like never pile up here.
+	void Push(const sf::Event& event, int64_t time) {
+		if (event.type != sf::Event::KeyPressed && event.type != sf::Event::KeyReleased &&
+			event.type != sf::Event::LostFocus)
+			return;
+
+		events.push_back({ event, time });
+	}
+
+	//Applies, in order, every event stamped before time. Later ones wait for a later tick.
+	void ApplyUntil(int64_t time, InputState& input) {
+		while (!events.empty() && events.front().time < time) {
+			input.HandleEvent(events.front().event);
+			events.pop_front();
+		}
+	}
+
+private:
+	struct TimedEvent {
+		sf::Event event;
+		int64_t time;
+	};
+
+	std::deque<TimedEvent> events;
+};
@@ -0,0 +1,37 @@
+#pragma once
+#include <SFML/Window/Event.hpp>
+#include <SFML/Window/Keyboard.hpp>
+#include <bitset>
+
+//Which keys are held, kept up to date from window events instead of asking the OS about each
+//key. Reading a key is a bit test, so it costs the same however many paddles or bindings read it.
+class InputState {
+public:
+	void HandleEvent(const sf::Event& event) {
+		switch (event.type) {
+		case sf::Event::KeyPressed:
+			if (IsValid(event.key.code)) held[event.key.code] = true;
+			break;
+		case sf::Event::KeyReleased:
+			if (IsValid(event.key.code)) held[event.key.code] = false;
+			break;
+		case sf::Event::LostFocus:
+			//Releases that happen while another window has focus never arrive
+			held.reset();
+			break;
+		default:
+			break;
+		}
+	}
+
+	bool IsDown(sf::Keyboard::Key key) const {
+		return IsValid(key) && held[key];
+	}
+
+private:
+	static bool IsValid(sf::Keyboard::Key key) {
+		return key >= 0 && key < sf::Keyboard::KeyCount;
+	}
+
+	std::bitset<sf::Keyboard::KeyCount> held;
+};
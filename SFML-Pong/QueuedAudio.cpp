@@ -0,0 +1,67 @@
+#include "QueuedAudio.h"
+#include <iostream>
+#include <thread>
+
+QueuedAudio::QueuedAudio(AssetCache& assets) : assets(assets), dropped(0) {
+}
+
+int QueuedAudio::LoadSound(const std::string& path) {
+	buffers.push_back(assets.GetSoundBuffer(path));
+	return (int)buffers.size() - 1;
+}
+
+int QueuedAudio::LoadTone(const ToneSettings& tone) {
+	std::shared_ptr<sf::SoundBuffer> buffer = std::make_shared<sf::SoundBuffer>();
+	if (!::LoadTone(*buffer, tone)) {
+		std::cout << "[ERROR: QueuedAudio.cpp]: Tone of " << tone.frequency << "Hz could not be synthesised" << std::endl;
+	}
+	buffers.push_back(buffer);
+	return (int)buffers.size() - 1;
+}
+
+void QueuedAudio::Play(int sound, const VoicePool::PlayParams& params) {
+	Command command;
+	command.type = CommandType::Play;
+	command.buffer = buffers[sound];
+	command.params = params;
+	Send(command, true);
+}
+
+void QueuedAudio::Pause(int sound) {
+	Command command;
+	command.type = CommandType::Pause;
+	command.buffer = buffers[sound];
+	Send(command, false);
+}
+
+void QueuedAudio::Stop(int sound) {
+	Command command;
+	command.type = CommandType::Stop;
+	command.buffer = buffers[sound];
+	Send(command, false);
+}
+
+void QueuedAudio::StopAll() {
+	Command command;
+	command.type = CommandType::StopAll;
+	Send(command, false);
+}
+
+void QueuedAudio::SetVolume(int sound, float volume) {
+	Command command;
+	command.type = CommandType::SetVolume;
+	command.buffer = buffers[sound];
+	command.params.volume = volume;
+	Send(command, false);
+}
+
+void QueuedAudio::Send(Command& command, bool mayDrop) {
+	while (!commands.TryPush(command)) {
+		//A Stop has to arrive, or a voice could outlive its buffer. It's rare enough to wait for.
+		if (mayDrop) {
+			dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		std::this_thread::yield();
+	}
+}
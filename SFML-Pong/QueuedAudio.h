@@ -0,0 +1,59 @@
+#pragma once
+#include "AudioBackend.h"
+#include "AssetCache.h"
+#include "SpscQueue.h"
+#include <SFML/Audio/SoundBuffer.hpp>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+//Front end for backends that do their audio work on a thread of their own. Each call becomes a
+//command in a lock-free ring that the backend's thread pops, so the game thread never waits on
+//the device. Every method must be called from the same thread (the ring has a single producer).
+class QueuedAudio : public AudioBackend {
+public:
+	int LoadSound(const std::string& path) override;
+	int LoadTone(const ToneSettings& tone) override;
+
+	//Dropped if the ring is full, since a late sound is worse than a missing one
+	void Play(int sound, const VoicePool::PlayParams& params) override;
+
+	void Pause(int sound) override;
+	void Stop(int sound) override;
+	void StopAll() override;
+	void SetVolume(int sound, float volume) override;
+
+	size_t GetDroppedCount() const { return dropped.load(std::memory_order_relaxed); }
+
+protected:
+	enum class CommandType : uint8_t {
+		Play,
+		Pause,
+		Stop,
+		StopAll,
+		SetVolume
+	};
+
+	//The buffer travels with the command, so it stays alive until the audio thread is done with it
+	struct Command {
+		CommandType type = CommandType::StopAll;
+		std::shared_ptr<const sf::SoundBuffer> buffer;
+		VoicePool::PlayParams params;
+	};
+
+	explicit QueuedAudio(AssetCache& assets);
+
+	//Only called from the backend's own thread
+	bool PopCommand(Command& command) { return commands.TryPop(command); }
+
+private:
+	void Send(Command& command, bool mayDrop);
+
+	AssetCache& assets;
+	std::vector<std::shared_ptr<const sf::SoundBuffer>> buffers;
+
+	SpscQueue<Command, 256> commands;
+	std::atomic<size_t> dropped;
+};
@@ -0,0 +1,95 @@
+#include "ScoreRenderer.h"
+
+//Empty pixels kept around each glyph so smoothing doesn't bleed neighbours into it, as sf::Text does
+static const int GlyphPadding = 1;
+
+ScoreRenderer::ScoreRenderer(const sf::Font& font, unsigned characterSize, bool bold) : characterSize(characterSize), vertices(sf::Triangles) {
+	sf::Glyph glyphs[10];
+	for (int i = 0; i < 10; i++) {
+		glyphs[i] = font.getGlyph('0' + i, characterSize, bold);
+	}
+
+	//One read back of the font's page now that every digit has been rasterised onto it
+	sf::Image page = font.getTexture(characterSize).copyToImage();
+
+	unsigned width = 0;
+	unsigned height = 0;
+	for (const sf::Glyph& glyph : glyphs) {
+		width += glyph.textureRect.width + GlyphPadding * 2;
+		if ((unsigned)glyph.textureRect.height + GlyphPadding * 2 > height)
+			height = glyph.textureRect.height + GlyphPadding * 2;
+	}
+
+	sf::Image image;
+	image.create(width, height, sf::Color(255, 255, 255, 0));
+
+	unsigned x = 0;
+	for (int i = 0; i < 10; i++) {
+		const sf::Glyph& glyph = glyphs[i];
+		sf::IntRect source(glyph.textureRect.left - GlyphPadding, glyph.textureRect.top - GlyphPadding,
+			glyph.textureRect.width + GlyphPadding * 2, glyph.textureRect.height + GlyphPadding * 2);
+
+		image.copy(page, x, 0, source);
+
+		Digit& digit = digits[i];
+		digit.bounds = sf::FloatRect(glyph.bounds.left - GlyphPadding, glyph.bounds.top - GlyphPadding,
+			glyph.bounds.width + GlyphPadding * 2, glyph.bounds.height + GlyphPadding * 2);
+		digit.textureRect = sf::FloatRect((float)x, 0.0f, (float)source.width, (float)source.height);
+		digit.advance = glyph.advance;
+
+		x += source.width;
+	}
+
+	atlas.loadFromImage(image);
+	atlas.setSmooth(true);
+}
+
+void ScoreRenderer::Begin() {
+	vertices.clear();
+}
+
+void ScoreRenderer::AddNumber(int value, sf::Vector2f position, sf::Color color) {
+	//Digits come out least significant first
+	char reversed[12];
+	int count = 0;
+	unsigned remaining = value > 0 ? (unsigned)value : 0;
+	do {
+		reversed[count++] = (char)(remaining % 10);
+		remaining /= 10;
+	} while (remaining > 0);
+
+	float x = position.x;
+	float baseline = position.y + characterSize;
+
+	while (count > 0) {
+		const Digit& digit = digits[(int)reversed[--count]];
+
+		float left = x + digit.bounds.left;
+		float top = baseline + digit.bounds.top;
+		float right = left + digit.bounds.width;
+		float bottom = top + digit.bounds.height;
+
+		float u0 = digit.textureRect.left;
+		float v0 = digit.textureRect.top;
+		float u1 = u0 + digit.textureRect.width;
+		float v1 = v0 + digit.textureRect.height;
+
+		vertices.append(sf::Vertex(sf::Vector2f(left, top), color, sf::Vector2f(u0, v0)));
+		vertices.append(sf::Vertex(sf::Vector2f(right, top), color, sf::Vector2f(u1, v0)));
+		vertices.append(sf::Vertex(sf::Vector2f(right, bottom), color, sf::Vector2f(u1, v1)));
+
+		vertices.append(sf::Vertex(sf::Vector2f(left, top), color, sf::Vector2f(u0, v0)));
+		vertices.append(sf::Vertex(sf::Vector2f(right, bottom), color, sf::Vector2f(u1, v1)));
+		vertices.append(sf::Vertex(sf::Vector2f(left, bottom), color, sf::Vector2f(u0, v1)));
+
+		x += digit.advance;
+	}
+}
+
+void ScoreRenderer::Draw(sf::RenderTarget& target) {
+	if (vertices.getVertexCount() == 0) return;
+
+	sf::RenderStates states;
+	states.texture = &atlas;
+	target.draw(vertices, states);
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+
+//Draws numbers from a tiny atlas holding only the digits 0-9, rasterised once at startup. Writing
+//a score is a few quads into a reused vertex array, so a changing score neither allocates nor
+//makes the font rasterise a glyph mid-rally the way sf::Text::setString does.
+class ScoreRenderer {
+public:
+	ScoreRenderer(const sf::Font& font, unsigned characterSize, bool bold = false);
+
+	void Begin();
+
+	//Lays the digits out the way sf::Text would with its origin at position
+	void AddNumber(int value, sf::Vector2f position, sf::Color color = sf::Color::White);
+
+	void Draw(sf::RenderTarget& target);
+
+private:
+	struct Digit {
+		sf::FloatRect bounds;
+		sf::FloatRect textureRect;
+		float advance;
+	};
+
+	Digit digits[10];
+	unsigned characterSize;
+
+	sf::Texture atlas;
+	sf::VertexArray vertices;
+};
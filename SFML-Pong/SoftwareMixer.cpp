@@ -0,0 +1,221 @@
+#include "SoftwareMixer.h"
+#include <SFML/System/Clock.hpp>
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PONG_MIX_SSE2
+#include <emmintrin.h>
+#endif
+
+//Adds gain * src to mix, sample for sample
+static void AccumulateSamples(float* mix, const int16_t* src, size_t count, float gain) {
+	size_t i = 0;
+#if defined(PONG_MIX_SSE2)
+	const __m128 vGain = _mm_set1_ps(gain);
+	for (; i + 8 <= count; i += 8) {
+		__m128i samples = _mm_loadu_si128((const __m128i*)(src + i));
+		//Widen to 32 bits keeping the sign by unpacking into the high half and shifting back down
+		__m128 low = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16));
+		__m128 high = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(samples, samples), 16));
+
+		_mm_storeu_ps(mix + i, _mm_add_ps(_mm_loadu_ps(mix + i), _mm_mul_ps(low, vGain)));
+		_mm_storeu_ps(mix + i + 4, _mm_add_ps(_mm_loadu_ps(mix + i + 4), _mm_mul_ps(high, vGain)));
+	}
+#endif
+	for (; i < count; i++) {
+		mix[i] += src[i] * gain;
+	}
+}
+
+//Clamps the mix into 16 bit samples. Both paths round to nearest even in the default rounding
+//mode, so the tail matches what _mm_cvtps_epi32 gives the rest of the block.
+static void ConvertSamples(const float* mix, int16_t* output, size_t count) {
+	size_t i = 0;
+#if defined(PONG_MIX_SSE2)
+	const __m128 vMin = _mm_set1_ps(-32768.0f);
+	const __m128 vMax = _mm_set1_ps(32767.0f);
+	for (; i + 8 <= count; i += 8) {
+		__m128i low = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(mix + i), vMin), vMax));
+		__m128i high = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(mix + i + 4), vMin), vMax));
+		_mm_storeu_si128((__m128i*)(output + i), _mm_packs_epi32(low, high));
+	}
+#endif
+	for (; i < count; i++) {
+		float sample = std::min(std::max(mix[i], -32768.0f), 32767.0f);
+		output[i] = (int16_t)std::nearbyint(sample);
+	}
+}
+
+const char* SoftwareMixer::MixKernelName() {
+#if defined(PONG_MIX_SSE2)
+	return "SSE2";
+#else
+	return "scalar";
+#endif
+}
+
+SoftwareMixer::Stream::Stream(SoftwareMixer& mixer, size_t blockFrames) : mixer(mixer), output(blockFrames * ChannelCount) {
+	initialize(ChannelCount, SampleRate);
+}
+
+SoftwareMixer::Stream::~Stream() {
+	//The stream thread calls onGetData, so it has to finish before this object goes away
+	stop();
+}
+
+bool SoftwareMixer::Stream::onGetData(Chunk& data) {
+	mixer.MixBlock(output.data());
+	data.samples = output.data();
+	data.sampleCount = output.size();
+	return true;
+}
+
+SoftwareMixer::SoftwareMixer(AssetCache& assets, size_t voiceCount, size_t blockFrames) : QueuedAudio(assets),
+	voices(voiceCount > 0 ? voiceCount : 1), mix(blockFrames * ChannelCount), blockFrames(blockFrames),
+	blocksMixed(0), mixMicroseconds(0), activeVoices(0) {
+	stream = std::make_unique<Stream>(*this, blockFrames);
+	stream->play();
+}
+
+SoftwareMixer::~SoftwareMixer() {
+	stream.reset();
+}
+
+SoftwareMixer::MixStats SoftwareMixer::GetMixStats() const {
+	MixStats stats;
+	stats.blocks = blocksMixed.load(std::memory_order_relaxed);
+	uint64_t microseconds = mixMicroseconds.load(std::memory_order_relaxed);
+	stats.averageMicroseconds = stats.blocks > 0 ? (double)microseconds / stats.blocks : 0.0;
+	stats.activeVoices = activeVoices.load(std::memory_order_relaxed);
+	return stats;
+}
+
+void SoftwareMixer::Execute(Command& command) {
+	switch (command.type) {
+	case CommandType::Play:
+		StartVoice(command);
+		break;
+	case CommandType::Pause:
+		for (Voice& voice : voices) {
+			if (voice.buffer == command.buffer) voice.paused = true;
+		}
+		break;
+	case CommandType::Stop:
+		for (Voice& voice : voices) {
+			if (voice.buffer == command.buffer) voice = Voice();
+		}
+		break;
+	case CommandType::StopAll:
+		for (Voice& voice : voices) {
+			voice = Voice();
+		}
+		break;
+	case CommandType::SetVolume:
+		for (Voice& voice : voices) {
+			if (voice.buffer == command.buffer) voice.gain = command.params.volume / 100.0f;
+		}
+		break;
+	}
+}
+
+void SoftwareMixer::StartVoice(const Command& command) {
+	const sf::SoundBuffer& buffer = *command.buffer;
+	const VoicePool::PlayParams& params = command.params;
+	if (buffer.getSampleCount() == 0 || buffer.getChannelCount() == 0) return;
+
+	VoiceChoice choice = ChooseVoice(voices, params,
+		[](const Voice& voice) { return !voice.buffer; },
+		[&command](const Voice& voice) { return voice.buffer == command.buffer; });
+	if (choice.voice < 0) return;
+
+	Voice& voice = voices[choice.voice];
+	voice.buffer = command.buffer;
+	voice.samples = buffer.getSamples();
+	voice.channels = buffer.getChannelCount();
+	voice.frames = (size_t)(buffer.getSampleCount() / voice.channels);
+	voice.position = 0.0;
+	voice.step = (double)params.pitch * buffer.getSampleRate() / SampleRate;
+	voice.gain = params.volume / 100.0f;
+	voice.priority = params.priority;
+	voice.started = ++playCounter;
+	voice.loop = params.loop;
+	voice.paused = false;
+}
+
+void SoftwareMixer::MixVoice(Voice& voice) {
+	size_t written = 0;
+
+	//Stereo at the output rate is a straight copy, so it goes through the SIMD accumulate
+	if (voice.step == 1.0 && voice.channels == ChannelCount) {
+		while (written < blockFrames) {
+			size_t start = (size_t)voice.position;
+			size_t count = std::min(voice.frames - start, blockFrames - written);
+			AccumulateSamples(mix.data() + written * ChannelCount, voice.samples + start * ChannelCount, count * ChannelCount, voice.gain);
+
+			written += count;
+			voice.position = (double)(start + count);
+			if (start + count >= voice.frames) {
+				if (!voice.loop) {
+					voice = Voice();
+					return;
+				}
+				voice.position = 0.0;
+			}
+		}
+		return;
+	}
+
+	//Anything else is resampled with linear interpolation. Mono goes to both sides and
+	//channels past the second are ignored.
+	unsigned rightChannel = voice.channels > 1 ? 1 : 0;
+	for (; written < blockFrames; written++) {
+		size_t index = (size_t)voice.position;
+		if (index >= voice.frames) {
+			if (!voice.loop) {
+				voice = Voice();
+				return;
+			}
+			voice.position -= (double)voice.frames;
+			index = (size_t)voice.position;
+		}
+
+		size_t next = index + 1 < voice.frames ? index + 1 : (voice.loop ? 0 : index);
+		float fraction = (float)(voice.position - (double)index);
+
+		const int16_t* a = voice.samples + index * voice.channels;
+		const int16_t* b = voice.samples + next * voice.channels;
+		float left = a[0] + (b[0] - a[0]) * fraction;
+		float right = a[rightChannel] + (b[rightChannel] - a[rightChannel]) * fraction;
+
+		mix[written * 2] += left * voice.gain;
+		mix[written * 2 + 1] += right * voice.gain;
+
+		voice.position += voice.step;
+	}
+}
+
+void SoftwareMixer::MixBlock(int16_t* output) {
+	sf::Clock clock;
+
+	Command command;
+	while (PopCommand(command)) {
+		Execute(command);
+		command = Command();
+	}
+
+	std::fill(mix.begin(), mix.end(), 0.0f);
+
+	size_t active = 0;
+	for (Voice& voice : voices) {
+		if (!voice.buffer || voice.paused) continue;
+		MixVoice(voice);
+		active++;
+	}
+
+	ConvertSamples(mix.data(), output, mix.size());
+
+	activeVoices.store(active, std::memory_order_relaxed);
+	mixMicroseconds.fetch_add((uint64_t)clock.getElapsedTime().asMicroseconds(), std::memory_order_relaxed);
+	blocksMixed.fetch_add(1, std::memory_order_relaxed);
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include "QueuedAudio.h"
+#include "AssetCache.h"
+#include <SFML/Audio/SoundStream.hpp>
+#include <SFML/Audio/SoundBuffer.hpp>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+//An AudioBackend that mixes every voice itself into one sf::SoundStream, so audio uses a single
+//OpenAL source however many sounds overlap. Mixing runs on the stream's thread in fixed blocks,
+//fed by the same QueuedAudio command ring as AudioThread. Output is 48kHz stereo, the
+//format of the game's WAVs; other rates and mono sounds are resampled as they're mixed.
+class SoftwareMixer : public QueuedAudio {
+public:
+	struct MixStats {
+		uint64_t blocks;
+		double averageMicroseconds;
+		size_t activeVoices;
+	};
+
+	static const unsigned SampleRate = 48000;
+	static const unsigned ChannelCount = 2;
+
+	//SFML keeps three blocks queued and refills them every 10ms, so blocks much below 512
+	//frames (10.7ms) risk running dry before the stream thread wakes
+	SoftwareMixer(AssetCache& assets, size_t voiceCount = 32, size_t blockFrames = 512);
+	~SoftwareMixer();
+
+	SoftwareMixer(const SoftwareMixer&) = delete;
+	SoftwareMixer& operator=(const SoftwareMixer&) = delete;
+
+	//Safe to call from the game thread while the stream is running
+	MixStats GetMixStats() const;
+
+	//Mixes the next block into output (blockFrames * 2 samples). Called by the stream.
+	void MixBlock(int16_t* output);
+
+	static const char* MixKernelName();
+
+private:
+	//A voice holds its buffer, so a sound can never be freed while it is being mixed
+	struct Voice {
+		std::shared_ptr<const sf::SoundBuffer> buffer;
+		const int16_t* samples = nullptr;
+		size_t frames = 0;
+		unsigned channels = 0;
+		double position = 0.0;
+		double step = 1.0;
+		float gain = 1.0f;
+		int priority = 0;
+		uint64_t started = 0;
+		bool loop = false;
+		bool paused = false;
+	};
+
+	class Stream : public sf::SoundStream {
+	public:
+		Stream(SoftwareMixer& mixer, size_t blockFrames);
+		~Stream();
+
+	protected:
+		bool onGetData(Chunk& data) override;
+		void onSeek(sf::Time) override {}
+
+	private:
+		SoftwareMixer& mixer;
+		std::vector<int16_t> output;
+	};
+
+	void Execute(Command& command);
+	void StartVoice(const Command& command);
+	void MixVoice(Voice& voice);
+
+	//Only touched by the stream thread
+	std::vector<Voice> voices;
+	std::vector<float> mix;
+	size_t blockFrames;
+	uint64_t playCounter = 0;
+
+	std::atomic<uint64_t> blocksMixed;
+	std::atomic<uint64_t> mixMicroseconds;
+	std::atomic<size_t> activeVoices;
+
+	std::unique_ptr<Stream> stream;
+};
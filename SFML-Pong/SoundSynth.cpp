@@ -0,0 +1,29 @@
+#include "SoundSynth.h"
+#include <cmath>
+
+std::vector<int16_t> SynthesiseSquareWave(const ToneSettings& tone, unsigned sampleRate) {
+	size_t count = (size_t)(tone.duration * sampleRate);
+	std::vector<int16_t> samples(count);
+
+	float amplitude = tone.volume * 32767.0f;
+	size_t ramp = sampleRate / 1000;
+	double period = sampleRate / (double)tone.frequency;
+
+	for (size_t i = 0; i < count; i++) {
+		double phase = std::fmod((double)i, period) / period;
+		float sample = phase < 0.5 ? amplitude : -amplitude;
+
+		if (i < ramp) sample *= (float)i / ramp;
+		if (count - i <= ramp) sample *= (float)(count - i - 1) / ramp;
+
+		samples[i] = (int16_t)sample;
+	}
+	return samples;
+}
+
+bool LoadTone(sf::SoundBuffer& buffer, const ToneSettings& tone, unsigned sampleRate) {
+	std::vector<int16_t> samples = SynthesiseSquareWave(tone, sampleRate);
+	if (samples.empty()) return false;
+
+	return buffer.loadFromSamples(samples.data(), samples.size(), 1, sampleRate);
+}
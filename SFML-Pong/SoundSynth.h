@@ -0,0 +1,18 @@
+#pragma once
+#include <SFML/Audio/SoundBuffer.hpp>
+#include <vector>
+#include <cstdint>
+
+//A square wave beep in the style of the original arcade Pong
+struct ToneSettings {
+	float frequency = 440.0f;
+	float duration = 0.05f;
+	//0 to 1 of full scale
+	float volume = 0.4f;
+};
+
+//Mono samples for tone. The first and last millisecond are ramped so the beep doesn't click.
+std::vector<int16_t> SynthesiseSquareWave(const ToneSettings& tone, unsigned sampleRate = 48000);
+
+//Fills buffer with the tone, no files or decoding involved
+bool LoadTone(sf::SoundBuffer& buffer, const ToneSettings& tone, unsigned sampleRate = 48000);
@@ -4,9 +4,27 @@
 #include <memory>
 #include <iostream>
 #include <random>
-
-#define SCREEN_WIDTH 1024
-#define SCREEN_HEIGHT 720
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+
+#include "Simulation.h"
+#include "FixedTimestep.h"
+#include "BallField.h"
+#include "AiController.h"
+#include "CourtRenderer.h"
+#include "ScoreRenderer.h"
+#include "AssetCache.h"
+#include "AssetArchive.h"
+#include "EmbeddedAssets.h"
+#include "AssetPreloader.h"
+#include "InputState.h"
+#include "InputQueue.h"
+#include "AudioBackend.h"
+#include "AudioThread.h"
+#include "SoftwareMixer.h"
+#include "AudioQueue.h"
 
 class Time {
 public:
@@ -24,97 +42,88 @@ float Time::deltaTime;
 sf::Clock Time::deltaClock;
 
 
+//Plays a sound through whichever AudioBackend the game was started with. With the OpenAL backend
+//overlapping hits layer on pooled voices instead of restarting each other.
 class SoundEffect {
 public:
-	SoundEffect() = default;
-
-	SoundEffect(const char* filename) {
+	SoundEffect(AudioBackend& audio, const char* filename, int priority = 0, unsigned maxInstances = 2) : audio(audio) {
 		SetPath(filename);
+		params.priority = priority;
+		params.maxInstances = maxInstances;
+	}
+
+	SoundEffect(AudioBackend& audio, const ToneSettings& tone, int priority = 0, unsigned maxInstances = 2) : audio(audio) {
+		sound = audio.LoadTone(tone);
+		params.priority = priority;
+		params.maxInstances = maxInstances;
+	}
+
+	~SoundEffect() {
+		audio.Stop(sound);
 	}
 
 	void SetPath(const char* filename) {
-		if (!soundBuffer.loadFromFile(filename)) {
-			std::cout << "[ERROR: Sound.cpp]: Sound buffer at " << filename << " could not be found" << std::endl;
-			return;
-		}
-		soundEffect.setBuffer(soundBuffer);
+		sound = audio.LoadSound(filename);
 	}
-	void Play() {
-		soundEffect.play();
+	void Play(float pitch = 1.0f) {
+		VoicePool::PlayParams playParams = params;
+		playParams.pitch = pitch;
+		audio.Play(sound, playParams);
 	}
 	void Pause() {
-		soundEffect.pause();
+		audio.Pause(sound);
 	}
 	void Stop() {
-		soundEffect.stop();
+		audio.Stop(sound);
 	}
 	void SetLooping(bool isLooped) {
-		soundEffect.setLoop(isLooped);
+		params.loop = isLooped;
+	}
+	void SetVolume(float volume) {
+		params.volume = volume;
+		audio.SetVolume(sound, volume);
 	}
 
 private:
-	sf::SoundBuffer soundBuffer;
-	sf::Sound soundEffect;
+	AudioBackend& audio;
+	VoicePool::PlayParams params;
+	int sound = -1;
 };
 
 class GameObject {
 public:
-	GameObject(sf::RenderWindow* window, sf::Vector2f position, sf::Color colorr, sf::Vector2f size) : window(window), position(position), color(color), size(size) {
+	GameObject(sf::RenderWindow* window, sf::Vector2f position, sf::Color color, sf::Vector2f size) : window(window), position(position), color(color), size(size) {
 
 	}
 
-	virtual void Draw() = 0;
+	virtual void Draw(CourtRenderer& renderer) = 0;
 
-	virtual void PollInput(float deltaTime, sf::Event* event) {}
-
-	virtual void Update() {}
-
-	virtual void Update(sf::Event* event) {}
-
-	void UpdateRects() {
-		transformRect.left = position.x;
-		transformRect.top = position.y;
-	}
+	virtual void SetPosition(sf::Vector2f newPosition) { position = newPosition; }
 
 	sf::Vector2f GetPosition() { return position; }
 	sf::Vector2f GetSize() { return size; }
-	sf::Rect<float> GetRect() { return transformRect; }
 
 protected:
-	sf::Vector2f position;
-	sf::Vector2f size;
+	sf::RenderWindow* window;
 
+	sf::Vector2f position;
 	sf::Color color;
-
-	sf::Rect<float> transformRect = sf::Rect<float>(position, size);
-
-	sf::RenderWindow* window;
+	sf::Vector2f size;
 };
 
+//Draws a paddle and its score. Movement and collision live in the Match simulation.
 class Paddle : public GameObject {
 public:
-	Paddle() = default;
-	Paddle(sf::RenderWindow* window, float xPos, sf::Color color, sf::Vector2f size, float movementSpeed = 3.0f) : GameObject(window, sf::Vector2f(xPos, SCREEN_HEIGHT / 2), color, size), movementSpeed(movementSpeed)
+	Paddle(sf::RenderWindow* window, float xPos, sf::Color color, sf::Vector2f size) : GameObject(window, sf::Vector2f(xPos, SCREEN_HEIGHT / 2), color, size)
 	{
-		paddleSprite.setSize(size);
-		paddleSprite.setPosition(sf::Vector2f(xPos, SCREEN_HEIGHT / 2));
-		paddleSprite.setFillColor(color);
-
-		scoreFont.loadFromFile("Assets/Fonts/good times.ttf");
-		scoreText = sf::Text("0", scoreFont, 30);
-		scoreText.setStyle(sf::Text::Bold);
-		
 		if (xPos < SCREEN_WIDTH / 2) {
-			scoreText.setPosition(sf::Vector2f((SCREEN_WIDTH / 2) - 140.0f, 0));
+			scorePosition = sf::Vector2f((SCREEN_WIDTH / 2) - 140.0f, 0);
 		}
 		else
 		{
-			scoreText.setPosition(sf::Vector2f((SCREEN_WIDTH / 2) + 100.0f, 0));
+			scorePosition = sf::Vector2f((SCREEN_WIDTH / 2) + 100.0f, 0);
 		}
 
-	}
-	~Paddle() {
-
 	}
 
 	void SetKeys(sf::Keyboard::Key up, sf::Keyboard::Key down) {
@@ -122,195 +131,419 @@ public:
 		downKey = down;
 	}
 
-	void Draw() override {
-		window->draw(paddleSprite);
-		window->draw(scoreText);
-	}
-
-	void PollInput(float deltaTime, sf::Event* event) override {
-		if (sf::Keyboard::isKeyPressed(upKey)) {
-			if (position.y > 0)
-				position.y = position.y - movementSpeed * deltaTime;
+	PaddleInput ReadInput(const InputState& input) const {
+		if (input.IsDown(upKey)) {
+			return PaddleInput::Up;
 		}
-		else if (sf::Keyboard::isKeyPressed(downKey)) {
-			if (position.y < SCREEN_HEIGHT - size.y)
-				position.y = position.y + movementSpeed * deltaTime;
+		else if (input.IsDown(downKey)) {
+			return PaddleInput::Down;
 		}
+		return PaddleInput::Idle;
 	}
 
-	void Update(sf::Event* event) override {
-		UpdateRects();
-
-		PollInput(Time::deltaTime, event);
-		paddleSprite.setPosition(position);
+	void Draw(CourtRenderer& renderer) override {
+		renderer.AddRect(position.x, position.y, size.x, size.y, color);
 	}
 
-	void IncrementScore() {
-		score++;
-		scoreText.setString(std::to_string(score));
+	void DrawScore(ScoreRenderer& scores) {
+		scores.AddNumber(score, scorePosition);
 	}
 
-	void ResetScore() {
-		score = 0;
-		scoreText.setString(std::to_string(score));
+	void SetScore(int newScore) {
+		score = newScore;
 	}
 
 private:
-	sf::RectangleShape paddleSprite;
-
 	sf::Keyboard::Key upKey = sf::Keyboard::Up;
 	sf::Keyboard::Key downKey = sf::Keyboard::Down;
 
-	float movementSpeed = 3.0f;
-
 	int score = 0;
-
-	sf::Font scoreFont;
-	sf::Text scoreText;
+	sf::Vector2f scorePosition;
 };
 
+//Draws the ball and queues its sounds in response to simulation events
 class Ball : public GameObject {
 public:
-	Ball(sf::RenderWindow* window, sf::Color color, float radius) : GameObject(window, sf::Vector2f(SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2), color, sf::Vector2f(radius * 2, radius * 2)) {
-		ballSprite = sf::CircleShape(radius);
-		Reset();
+	Ball(sf::RenderWindow* window, AudioBackend& audioBackend, AudioQueue& audio, sf::Color color, float radius, bool synthesiseSounds = false) : GameObject(window, sf::Vector2f(SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2), color, sf::Vector2f(radius * 2, radius * 2)), audio(audio) {
+		//Paddle hits win over wall hits when the pool is full
+		if (synthesiseSounds) {
+			//The arcade machine's beeps: a low blip off the walls and a higher one off the paddles
+			ToneSettings wallTone;
+			wallTone.frequency = 226.0f;
+			wallTone.duration = 0.03f;
+			ToneSettings paddleTone;
+			paddleTone.frequency = 459.0f;
+			paddleTone.duration = 0.05f;
+
+			wallSound = std::make_unique<SoundEffect>(audioBackend, wallTone, 0, 3);
+			scoreSound = std::make_unique<SoundEffect>(audioBackend, paddleTone, 1, 3);
+		}
+		else {
+			wallSound = std::make_unique<SoundEffect>(audioBackend, "Assets/Sounds/wallHit.wav", 0, 3);
+			scoreSound = std::make_unique<SoundEffect>(audioBackend, "Assets/Sounds/paddleHit.Wav", 1, 3);
+		}
 
-		wallSound = std::make_unique<SoundEffect>("Assets/Sounds/wallHit.wav");
-		scoreSound = std::make_unique<SoundEffect>("Assets/Sounds/paddleHit.Wav");
+		wallSoundId = audio.AddSound(0.03f);
+		scoreSoundId = audio.AddSound(0.03f);
 	}
 
-	void Draw() override {
-		window->draw(ballSprite);
+	void Draw(CourtRenderer& renderer) override {
+		renderer.AddBall(position.x, position.y, size.x, color);
 	}
 
-	void Update() override {
-		UpdateRects();
-
-		if (position.x < 0) {
-			Reset();
+	//Called per tick, so it only records the hits
+	void QueueEvents(uint32_t events, float pitch = 1.0f) {
+		if (events & EventWallHit) {
+			audio.Push(wallSoundId, 1, pitch);
 		}
-		else if (position.x > SCREEN_WIDTH) {
-			Reset();
+		if (events & (EventLeftPaddleHit | EventRightPaddleHit)) {
+			audio.Push(scoreSoundId, 1, pitch);
 		}
+	}
+	void QueueHits(size_t wallHits, size_t paddleHits) {
+		audio.Push(wallSoundId, wallHits);
+		audio.Push(scoreSoundId, paddleHits);
+	}
+
+	//Called once per frame after the ticks
+	void FlushSounds(float now) {
+		audio.Flush(now, [this](int sound, size_t, float pitch) {
+			if (sound == wallSoundId) wallSound->Play(pitch);
+			else if (sound == scoreSoundId) scoreSound->Play(pitch);
+		});
+	}
+
+private:
+	AudioQueue& audio;
+	int wallSoundId;
+	int scoreSoundId;
+
+	std::unique_ptr<SoundEffect> scoreSound;
+	std::unique_ptr<SoundEffect> wallSound;
+};
+
+sf::Vector2f Lerp(Real fromX, Real fromY, Real toX, Real toY, float alpha) {
+	sf::Vector2f from(ToFloat(fromX), ToFloat(fromY));
+	sf::Vector2f to(ToFloat(toX), ToFloat(toY));
+	return from + (to - from) * alpha;
+}
+
+//Directory part of the executable path, with its trailing separator
+std::string ExecutableDirectory(const char* executablePath) {
+	std::string path = executablePath ? executablePath : "";
+	size_t separator = path.find_last_of("/\\");
+	return separator == std::string::npos ? std::string() : path.substr(0, separator + 1);
+}
 
-		if (position.y < 0) {
-			HitWall();
+int main(int argc, char** argv)
+{
+	sf::Clock startupClock;
+
+	float tickRate = 120.0f;
+	int maxTicksPerFrame = 8;
+	size_t stressBalls = 0;
+	uint64_t seed = std::random_device()();
+	bool cpuOpponent = false;
+	bool assetReport = false;
+	bool noAudio = false;
+	bool softwareMixer = false;
+	bool synthesiseSounds = false;
+	const char* packPath = nullptr;
+	AiSettings cpuSettings;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--tick-rate") == 0 && i + 1 < argc) {
+			tickRate = (float)atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--max-catch-up") == 0 && i + 1 < argc) {
+			maxTicksPerFrame = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--balls") == 0 && i + 1 < argc) {
+			stressBalls = (size_t)atol(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+			seed = strtoull(argv[++i], nullptr, 10);
+		}
+		else if (strcmp(argv[i], "--no-audio") == 0) {
+			noAudio = true;
+		}
+		else if (strcmp(argv[i], "--synth-sounds") == 0) {
+			synthesiseSounds = true;
+		}
+		else if (strcmp(argv[i], "--mixer") == 0) {
+			softwareMixer = true;
+		}
+		else if (strcmp(argv[i], "--pack") == 0 && i + 1 < argc) {
+			packPath = argv[++i];
+		}
+		else if (strcmp(argv[i], "--asset-report") == 0) {
+			assetReport = true;
+		}
+		else if (strcmp(argv[i], "--cpu") == 0) {
+			cpuOpponent = true;
+		}
+		else if (strcmp(argv[i], "--cpu-delay") == 0 && i + 1 < argc) {
+			cpuSettings.reactionDelay = (float)atof(argv[++i]);
 		}
-		else if (position.y + size.y > SCREEN_HEIGHT) {
-			HitWall();
+		else if (strcmp(argv[i], "--cpu-noise") == 0 && i + 1 < argc) {
+			cpuSettings.errorNoise = (float)atof(argv[++i]);
 		}
+	}
 
-		position += velocity * Time::deltaTime;
+	if (tickRate <= 0.0f) {
+		std::cout << "[ERROR: Source.cpp]: Tick rate must be positive, using 120" << std::endl;
+		tickRate = 120.0f;
+	}
 
-		ballSprite.setPosition(position);
+	//Run by the post-build step from the project directory
+	if (packPath) {
+		return AssetArchive::Pack("Assets", packPath) ? 0 : 1;
 	}
 
-	void Reset() {
-		position = sf::Vector2f(SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2);
+	AssetCache assets;
 
-		float xVel = rand() % 2 ? xVel = movementSpeed : xVel = -movementSpeed;
-		float yVel = rand() % (int)movementSpeed;
+	//The archive the post-build step leaves next to the executable, so the game starts from any
+	//working directory. Without it assets come from the loose files as before. A build with the
+	//assets compiled in doesn't look for either.
+	if (GetEmbeddedAssetCount() == 0) {
+		std::shared_ptr<AssetArchive> archive = std::make_shared<AssetArchive>();
+		if (archive->Open(ExecutableDirectory(argv[0]) + "assets.pak") || archive->Open("assets.pak")) {
+			assets.Mount(archive);
+		}
+	}
 
-		velocity = { xVel, yVel };
+	//Font parsing and WAV decoding run in the background while the window and GL context are created
+	AssetPreloader preload(assets);
+	preload.Font("Assets/Fonts/good times.ttf");
+	if (!noAudio && !synthesiseSounds) {
+		preload.SoundBuffers({ "Assets/Sounds/wallHit.wav", "Assets/Sounds/paddleHit.Wav" });
 	}
 
-	void HitPaddle() {
-		scoreSound->Play();
+	auto* window = new sf::RenderWindow(sf::VideoMode(SCREEN_WIDTH, SCREEN_HEIGHT), "SFML Pong");
+	window->setVerticalSyncEnabled(true);
+	//Frames are limited to 60 by the game loop itself, which reads input while it waits
+	const sf::Time frameLength = sf::seconds(1.0f / 60.0f);
 
-		if (position.x < SCREEN_WIDTH / 2) {
-			position.x = 0 + 36.0f;
-		}
-		else {
-			position.x = SCREEN_WIDTH - 37.0f - size.x;
+	CourtRenderer renderer;
+
+	//Loading screen: a progress bar until every asset is in
+	while (!preload.IsDone() && window->isOpen()) {
+		sf::Event event;
+		while (window->pollEvent(event)) {
+			if (event.type == sf::Event::Closed)
+				window->close();
 		}
 
-		velocity = { -velocity.x, (float)(-rand() % (int)movementSpeed) };
-	}
+		float progress = (float)preload.Poll() / preload.GetCount();
+		float barWidth = SCREEN_WIDTH / 2.0f;
+		float barX = (SCREEN_WIDTH - barWidth) / 2;
+		float barY = SCREEN_HEIGHT / 2.0f - 5.0f;
 
-	void HitWall() {
-		velocity.y = -velocity.y;
-		wallSound->Play();
+		window->clear();
+		renderer.Begin();
+		renderer.AddRect(barX, barY, barWidth, 10.0f, sf::Color(60, 60, 60));
+		renderer.AddRect(barX, barY, barWidth * progress, 10.0f, sf::Color::White);
+		renderer.Draw(*window);
+		window->display();
+
+		//Leaves the loader threads the CPU between frames
+		sf::sleep(frameLength);
 	}
 
-private:
-	sf::Vector2f velocity;
+	if (!window->isOpen()) {
+		delete window;
+		return 0;
+	}
+	std::cout << "Assets loaded after " << startupClock.getElapsedTime().asMilliseconds() << "ms" << std::endl;
 
-	sf::CircleShape ballSprite;
+	std::cout << "Match seed: " << seed << std::endl;
 
-	float movementSpeed = 250.0f;
+	Match match(MatchConfig(), seed);
+	const MatchConfig& config = match.GetConfig();
+	sf::Vector2f paddleSize(ToFloat(config.paddleWidth), ToFloat(config.paddleHeight));
 
-	std::unique_ptr<SoundEffect> scoreSound;
-	std::unique_ptr<SoundEffect> wallSound;
-};
+	FixedTimestep timestep(tickRate, maxTicksPerFrame);
+	Real tickLength = timestep.GetTickLength();
+	MatchState previousState = match.GetState();
+	bool ballTeleported = false;
 
-bool CheckCollision(GameObject& a, GameObject& b) {
-	if (a.GetRect().intersects(b.GetRect())) {
-		return true;
+	//Sounds are loaded through the backend, so --no-audio never opens an audio device
+	std::unique_ptr<AudioBackend> audioBackend;
+	SoftwareMixer* mixer = nullptr;
+	if (noAudio) {
+		audioBackend = std::make_unique<NullAudio>();
 	}
-	return false;
-}
+	else if (softwareMixer) {
+		//Mixes every voice into one stream on a single OpenAL source
+		audioBackend = std::make_unique<SoftwareMixer>(assets, 32, 512);
+		mixer = static_cast<SoftwareMixer*>(audioBackend.get());
+		std::cout << SoftwareMixer::MixKernelName() << " software mixer" << std::endl;
+	}
+	else {
+		audioBackend = std::make_unique<AudioThread>(assets, 16);
+	}
+	AudioQueue audio;
+	sf::Clock audioClock;
 
-int main()
-{
-	auto* window = new sf::RenderWindow(sf::VideoMode(SCREEN_WIDTH, SCREEN_HEIGHT), "SFML Pong");
-	window->setVerticalSyncEnabled(true);
-	window->setFramerateLimit(60);
+	std::shared_ptr<const sf::Font> scoreFont = assets.GetFont("Assets/Fonts/good times.ttf");
+	ScoreRenderer scores(*scoreFont, 30, true);
 
-	std::shared_ptr<Paddle> leftPaddle = std::make_shared<Paddle>(window, 15, sf::Color::Red, sf::Vector2f(20, 100), 120.0f);
+	std::shared_ptr<Paddle> leftPaddle = std::make_shared<Paddle>(window, ToFloat(config.leftPaddleX), sf::Color::Red, paddleSize);
 	leftPaddle->SetKeys(sf::Keyboard::W, sf::Keyboard::S);
 
-	std::shared_ptr<Paddle> rightPaddle = std::make_shared<Paddle>(window, SCREEN_WIDTH - 35, sf::Color::Green, sf::Vector2f(20, 100), 120.0f);
+	std::shared_ptr<Paddle> rightPaddle = std::make_shared<Paddle>(window, ToFloat(config.rightPaddleX), sf::Color::Green, paddleSize);
 
-	std::shared_ptr<Ball> ball = std::make_shared<Ball>(window, sf::Color::White, 16.0f);
+	//With --cpu the right paddle is played by the computer instead of the arrow keys
+	AiController cpu(PaddleSide::Right, cpuSettings, seed);
 
-	while (window->isOpen())
-	{
-		Time::UpdateTimer();
+	std::shared_ptr<Ball> ball = std::make_shared<Ball>(window, *audioBackend, audio, sf::Color::White, ToFloat(config.ballRadius), synthesiseSounds);
+
+	//Multi-ball stress mode
+	BallField field(config, 3.0f, seed);
+	field.Spawn(stressBalls);
+	sf::Color fieldColor(200, 200, 255);
 
+	//Everything has its own handle to the assets now
+	preload.Release();
+
+	if (assetReport) {
+		assets.PrintReport(std::cout);
+	}
+	sf::Clock statsClock;
+	sf::Time fieldStepTime;
+	int fieldFrames = 0;
+	bool firstFrame = true;
+
+	//Key states come from window events, so nothing queries the keyboard directly. Each event is
+	//stamped when it's taken off the window's queue and applied at the tick covering that time.
+	InputState input;
+	InputQueue inputQueue;
+	sf::Clock inputClock;
+	sf::Clock frameClock;
+
+	auto pollInput = [&]() {
 		sf::Event event;
 		while (window->pollEvent(event))
 		{
 			if (event.type == sf::Event::Closed)
 				window->close();
+			else
+				inputQueue.Push(event, inputClock.getElapsedTime().asMicroseconds());
+		}
+	};
+
+	while (window->isOpen())
+	{
+		frameClock.restart();
+		pollInput();
+
+		//Taken after the poll so everything it just stamped falls before the end of this frame's
+		//ticks instead of waiting a whole frame for the next ones
+		Time::UpdateTimer();
+		int64_t frameTime = inputClock.getElapsedTime().asMicroseconds();
+
+		int ticks = timestep.Advance(Time::deltaTime);
+		int64_t tickMicroseconds = (int64_t)(timestep.GetTickLength() * 1000000.0f);
+		int64_t simulatedUntil = frameTime - (int64_t)(timestep.GetAccumulator() * 1000000.0f);
 
-			if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::R)) {
-				ball->Reset();
+		for (int i = 0; i < ticks; i++) {
+			previousState = match.GetState();
+
+			//Everything that happened before this tick ends, including the rest of the last frame
+			int64_t tickEnd = simulatedUntil - (ticks - 1 - i) * tickMicroseconds;
+			inputQueue.ApplyUntil(tickEnd, input);
+
+			bool resetBall = input.IsDown(sf::Keyboard::Key::R);
+			if (resetBall) {
+				match.ResetBall();
+				previousState = match.GetState();
 			}
-		}
 
-		leftPaddle->Update(&event);
-		rightPaddle->Update(&event);
-		ball->Update();
+			PaddleInput leftInput = leftPaddle->ReadInput(input);
+			PaddleInput rightInput = rightPaddle->ReadInput(input);
+			if (cpuOpponent) {
+				rightInput = cpu.Decide(previousState, config, tickLength);
+			}
 
-		//Checks collision with the paddle on the side that the ball is currently on
-		if (ball->GetPosition().x < SCREEN_WIDTH / 2) {
-			if (CheckCollision(*ball, *leftPaddle)) {
-				ball->HitPaddle();
-				leftPaddle->IncrementScore();
+			uint32_t events = match.Step(leftInput, rightInput, tickLength);
+			ballTeleported = resetBall || (events & (EventLeftGoal | EventRightGoal)) != 0;
+			//Synthesised beeps rise in pitch as the ball speeds up
+			float pitch = 1.0f;
+			if (synthesiseSounds) {
+				float vx = ToFloat(match.GetState().ball.velocity.x);
+				float vy = ToFloat(match.GetState().ball.velocity.y);
+				pitch = std::sqrt(vx * vx + vy * vy) / ToFloat(config.ballSpeed);
 			}
-		}
-		else
-		{
-			if (CheckCollision(*ball, *rightPaddle)) {
-				ball->HitPaddle();
-				rightPaddle->IncrementScore();
+			ball->QueueEvents(events, pitch);
+
+			if (field.Size() > 0) {
+				sf::Clock stepClock;
+				BallField::Stats hits = field.Step(ToFloat(match.GetState().left.y), ToFloat(match.GetState().right.y), ToFloat(tickLength));
+				fieldStepTime += stepClock.getElapsedTime();
+				ball->QueueHits(hits.wallHits, hits.paddleHits);
 			}
 		}
+		ball->FlushSounds(audioClock.getElapsedTime().asSeconds());
 
-		if (ball->GetPosition().x < 0) {
-			leftPaddle->ResetScore();
-		}
-		else if (ball->GetPosition().x > SCREEN_WIDTH) {
-			rightPaddle->ResetScore();
-		}
+		//Render between the last two ticks so motion stays smooth when the tick rate and refresh rate differ
+		const MatchState& state = match.GetState();
+		float alpha = timestep.GetAlpha();
+		float ballAlpha = ballTeleported ? 1.0f : alpha;
+
+		leftPaddle->SetPosition(Lerp(config.leftPaddleX, previousState.left.y, config.leftPaddleX, state.left.y, alpha));
+		leftPaddle->SetScore(state.left.score);
+		rightPaddle->SetPosition(Lerp(config.rightPaddleX, previousState.right.y, config.rightPaddleX, state.right.y, alpha));
+		rightPaddle->SetScore(state.right.score);
+		ball->SetPosition(Lerp(previousState.ball.position.x, previousState.ball.position.y, state.ball.position.x, state.ball.position.y, ballAlpha));
 
 		window->clear();
 
-		leftPaddle->Draw();
-		rightPaddle->Draw();
-		ball->Draw();
+		//Everything on the court goes out in one draw call, then the scores in a second
+		renderer.Begin();
+		renderer.AddCourtMarkings(ToFloat(config.courtWidth), ToFloat(config.courtHeight), sf::Color(90, 90, 90));
+		leftPaddle->Draw(renderer);
+		rightPaddle->Draw(renderer);
+		ball->Draw(renderer);
+		renderer.AddBalls(field.X(), field.Y(), field.Size(), field.GetRadius() * 2.0f, fieldColor);
+		renderer.Draw(*window);
+
+		scores.Begin();
+		leftPaddle->DrawScore(scores);
+		rightPaddle->DrawScore(scores);
+		scores.Draw(*window);
+
+		if (field.Size() > 0) {
+
+			fieldFrames++;
+			if (statsClock.getElapsedTime().asSeconds() >= 1.0f) {
+				const AudioQueue::Stats& sounds = audio.GetStats();
+				std::cout << field.Size() << " balls: " << (fieldStepTime.asSeconds() * 1000.0f / fieldFrames) << "ms simulation per frame, "
+					<< (fieldFrames / statsClock.restart().asSeconds()) << " FPS, " << sounds.pushed << " sounds queued, "
+					<< sounds.played << " played, " << sounds.rateLimited << " rate limited" << std::endl;
+				if (mixer) {
+					SoftwareMixer::MixStats mixStats = mixer->GetMixStats();
+					std::cout << "Mixer: " << mixStats.activeVoices << " voices, " << mixStats.averageMicroseconds << "us per block, "
+						<< mixer->GetDroppedCount() << " plays dropped" << std::endl;
+				}
+				audio.ResetStats();
+				fieldStepTime = sf::Time::Zero;
+				fieldFrames = 0;
+			}
+		}
 
 		window->display();
+
+		if (firstFrame) {
+			std::cout << "Time to first frame: " << startupClock.getElapsedTime().asMilliseconds() << "ms" << std::endl;
+			firstFrame = false;
+		}
+
+		//Wait out the rest of the frame taking events as they arrive, so their stamps are within
+		//a millisecond or so of when they happened rather than rounded to the frame
+		while (window->isOpen() && frameClock.getElapsedTime() < frameLength) {
+			pollInput();
+			sf::sleep(sf::milliseconds(1));
+		}
 	}
 
 	delete window;
@@ -0,0 +1,49 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+
+//Fixed-capacity ring for exactly one producer thread and one consumer thread. Neither side ever
+//locks or allocates: each owns one index and only reads the other's. Capacity must be a power of two.
+template<typename T, size_t Capacity>
+class SpscQueue {
+	static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "SpscQueue capacity must be a power of two");
+
+public:
+	SpscQueue() : head(0), tail(0) {}
+
+	//Producer only. Returns false without touching item when the ring is full.
+	bool TryPush(T& item) {
+		size_t write = tail.load(std::memory_order_relaxed);
+		if (write - head.load(std::memory_order_acquire) == Capacity) return false;
+
+		slots[write & (Capacity - 1)] = std::move(item);
+		tail.store(write + 1, std::memory_order_release);
+		return true;
+	}
+
+	//Consumer only
+	bool TryPop(T& item) {
+		size_t read = head.load(std::memory_order_relaxed);
+		if (read == tail.load(std::memory_order_acquire)) return false;
+
+		T& slot = slots[read & (Capacity - 1)];
+		item = std::move(slot);
+		slot = T();
+		head.store(read + 1, std::memory_order_release);
+		return true;
+	}
+
+	bool IsEmpty() const {
+		return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+	}
+
+private:
+	T slots[Capacity];
+
+	//Each index on its own cache line so the two threads don't fight over one
+	char padding0[64];
+	std::atomic<size_t> head;
+	char padding1[64 - sizeof(std::atomic<size_t>)];
+	std::atomic<size_t> tail;
+	char padding2[64 - sizeof(std::atomic<size_t>)];
+};
@@ -0,0 +1,75 @@
+#include "VoicePool.h"
+
+VoicePool::VoicePool(size_t voiceCount) : voices(voiceCount > 0 ? voiceCount : 1) {
+}
+
+bool VoicePool::IsBusy(const Voice& voice) const {
+	return voice.buffer != nullptr && voice.sound.getStatus() != sf::Sound::Stopped;
+}
+
+int VoicePool::Play(const sf::SoundBuffer& buffer, const PlayParams& params) {
+	stats.plays++;
+
+	VoiceChoice choice = ChooseVoice(voices, params,
+		[this](const Voice& voice) { return !IsBusy(voice); },
+		[&buffer](const Voice& voice) { return voice.buffer == &buffer; });
+
+	if (choice.voice < 0) {
+		stats.dropped++;
+		return -1;
+	}
+	if (choice.stolen) stats.stolen++;
+
+	Voice& voice = voices[choice.voice];
+	voice.sound.stop();
+	if (voice.buffer != &buffer) {
+		voice.sound.setBuffer(buffer);
+		voice.buffer = &buffer;
+	}
+	voice.priority = params.priority;
+	voice.started = ++playCounter;
+
+	voice.sound.setVolume(params.volume);
+	voice.sound.setPitch(params.pitch);
+	voice.sound.setLoop(params.loop);
+	voice.sound.play();
+	return choice.voice;
+}
+
+void VoicePool::Pause(const sf::SoundBuffer& buffer) {
+	for (Voice& voice : voices) {
+		if (voice.buffer == &buffer && voice.sound.getStatus() == sf::Sound::Playing)
+			voice.sound.pause();
+	}
+}
+
+void VoicePool::Stop(const sf::SoundBuffer& buffer) {
+	//Detaches the buffer too, so it can be freed once the effect using it goes away
+	for (Voice& voice : voices) {
+		if (voice.buffer == &buffer) {
+			voice.sound.resetBuffer();
+			voice.buffer = nullptr;
+		}
+	}
+}
+
+void VoicePool::SetVolume(const sf::SoundBuffer& buffer, float volume) {
+	for (Voice& voice : voices) {
+		if (voice.buffer == &buffer)
+			voice.sound.setVolume(volume);
+	}
+}
+
+void VoicePool::StopAll() {
+	for (Voice& voice : voices) {
+		voice.sound.stop();
+	}
+}
+
+size_t VoicePool::GetActiveCount() const {
+	size_t active = 0;
+	for (const Voice& voice : voices) {
+		if (IsBusy(voice)) active++;
+	}
+	return active;
+}
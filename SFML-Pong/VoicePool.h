@@ -0,0 +1,106 @@
+#pragma once
+#include <SFML/Audio/Sound.hpp>
+#include <SFML/Audio/SoundBuffer.hpp>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+//A fixed set of sf::Sound voices shared by every sound effect. Each voice holds an OpenAL source,
+//so the pool size is the most sources the game will ever use however many collisions happen.
+//A play request takes a free voice, or steals the lowest priority (then oldest) one that isn't
+//more important than the new sound.
+class VoicePool {
+public:
+	struct PlayParams {
+		int priority = 0;
+		//Most voices this buffer may use at once. Past it the oldest one is restarted.
+		unsigned maxInstances = 2;
+		float volume = 100.0f;
+		float pitch = 1.0f;
+		bool loop = false;
+	};
+
+	struct Stats {
+		size_t plays = 0;
+		size_t stolen = 0;
+		size_t dropped = 0;
+	};
+
+	explicit VoicePool(size_t voiceCount = 16);
+
+	//Returns the voice used, or -1 when every voice is busy with something more important
+	int Play(const sf::SoundBuffer& buffer, const PlayParams& params);
+
+	//Applies to every voice currently using buffer. Stop must be called before buffer is destroyed.
+	void Pause(const sf::SoundBuffer& buffer);
+	void Stop(const sf::SoundBuffer& buffer);
+	void SetVolume(const sf::SoundBuffer& buffer, float volume);
+	void StopAll();
+
+	size_t GetVoiceCount() const { return voices.size(); }
+	size_t GetActiveCount() const;
+	const Stats& GetStats() const { return stats; }
+
+private:
+	struct Voice {
+		sf::Sound sound;
+		const sf::SoundBuffer* buffer = nullptr;
+		int priority = 0;
+		uint64_t started = 0;
+	};
+
+	bool IsBusy(const Voice& voice) const;
+
+	std::vector<Voice> voices;
+	uint64_t playCounter = 0;
+	Stats stats;
+};
+
+//The voice a new sound takes in a pool: the sound's oldest voice once it already has maxInstances,
+//else a free voice, else the lowest priority (then oldest) voice that isn't more important than
+//it. Voices need priority and started members; isFree and isSameSound look at one voice each.
+//Shared by VoicePool and SoftwareMixer so both steal the same way.
+struct VoiceChoice {
+	int voice = -1;
+	bool stolen = false;
+};
+
+template<typename Voice, typename IsFree, typename IsSameSound>
+VoiceChoice ChooseVoice(const std::vector<Voice>& voices, const VoicePool::PlayParams& params, IsFree isFree, IsSameSound isSameSound) {
+	//One pass finds everything needed: a free voice, this sound's oldest voice and the cheapest one to steal
+	int freeVoice = -1;
+	int oldestInstance = -1;
+	int victim = -1;
+	unsigned instances = 0;
+
+	for (int i = 0; i < (int)voices.size(); i++) {
+		const Voice& voice = voices[i];
+		if (isFree(voice)) {
+			if (freeVoice < 0) freeVoice = i;
+			continue;
+		}
+
+		if (isSameSound(voice)) {
+			instances++;
+			if (oldestInstance < 0 || voice.started < voices[oldestInstance].started)
+				oldestInstance = i;
+		}
+
+		if (victim < 0 || voice.priority < voices[victim].priority ||
+			(voice.priority == voices[victim].priority && voice.started < voices[victim].started))
+			victim = i;
+	}
+
+	VoiceChoice choice;
+	if (params.maxInstances > 0 && instances >= params.maxInstances) {
+		choice.voice = oldestInstance;
+	}
+	else if (freeVoice >= 0) {
+		choice.voice = freeVoice;
+	}
+	else if (victim >= 0 && voices[victim].priority <= params.priority) {
+		choice.voice = victim;
+		choice.stolen = true;
+	}
+	return choice;
+}